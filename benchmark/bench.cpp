@@ -0,0 +1,440 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/resource.h>
+#include "../json.hpp"
+#ifdef HEX_BENCH_NLOHMANN
+#include <nlohmann/json.hpp>
+#endif
+#ifdef HEX_BENCH_RAPIDJSON
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+#endif
+
+/* The benchmark suite: parse, serialize, lookup and round trip workloads over canada.json,
+ * citm.json and generated inputs (numbers, strings, deep nesting), run with hex::json and, if
+ * CMake found them, nlohmann::json and RapidJSON.
+ * Every workload is warmed up and then repeated until it has run both `min_runs` times and for
+ * `min_time` seconds. The table shows the median, MB/s and ns per node at the median, allocations
+ * per run and the peak RSS while the workload ran; --json writes all of it, one result per line,
+ * so results of two commits can be diffed.
+ *
+ * Usage: bench [--json results.json] [--quick] [filter...]
+ * A filter keeps only the results whose "input/library/workload" contains it.
+ */
+
+// Allocation counting
+// {{{
+static std::atomic<size_t> allocations{0}, allocated_bytes{0};
+
+static void *counted_alloc(size_t n, size_t align){
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(n, std::memory_order_relaxed);
+    void *p = align <= alignof(std::max_align_t) ? malloc(n ? n : 1)
+                                                 : aligned_alloc(align, (n + align - 1) / align * align);
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+void *operator new(size_t n){
+    return counted_alloc(n, 0);
+}
+void *operator new[](size_t n){
+    return counted_alloc(n, 0);
+}
+void *operator new(size_t n, std::align_val_t align){
+    return counted_alloc(n, (size_t)align);
+}
+void *operator new[](size_t n, std::align_val_t align){
+    return counted_alloc(n, (size_t)align);
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { free(p); }
+// }}}
+
+/* Peak RSS of one workload: Linux can reset the high-water mark, elsewhere it's the process's. */
+static void reset_peak_rss(){
+    std::ofstream clear("/proc/self/clear_refs");
+    if(clear) clear << "5";
+}
+static size_t peak_rss_kb(){
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line)){
+        if(line.compare(0, 6, "VmHWM:") == 0) return strtoull(line.c_str() + 6, nullptr, 10);
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+struct input {
+    std::string name, text;
+    size_t nodes = 0;
+};
+
+struct result {
+    std::string input, library, workload;
+    size_t bytes, items;                // per run; items are nodes, or lookups (which have no bytes)
+    std::vector<double> seconds;        // sorted
+    size_t allocations, allocated_bytes, peak_rss_kb;
+    double median() const {
+        size_t n = seconds.size();
+        return n % 2 ? seconds[n / 2] : (seconds[n / 2 - 1] + seconds[n / 2]) / 2;
+    }
+    double mean() const {
+        double sum = 0;
+        for(double s : seconds) sum += s;
+        return sum / seconds.size();
+    }
+    double stddev() const {
+        double m = mean(), sum = 0;
+        for(double s : seconds) sum += (s - m) * (s - m);
+        return seconds.size() > 1 ? std::sqrt(sum / (seconds.size() - 1)) : 0;
+    }
+};
+
+struct options {
+    int warmups = 2, min_runs = 10, max_runs = 1000;
+    double min_time = 0.5;
+    std::vector<std::string> filters;
+    std::string json_path;
+};
+
+class suite {
+    options opt;
+    std::vector<result> results;
+    volatile size_t sink = 0;   // so nothing gets optimized away
+    public:
+    explicit suite(options opt) : opt(std::move(opt)) {}
+    bool wanted(const std::string& name) const {
+        if(opt.filters.empty()) return true;
+        for(const std::string& f : opt.filters){
+            if(name.find(f) != std::string::npos) return true;
+        }
+        return false;
+    }
+    /* Times run(), which returns something that depends on its work. */
+    template<typename F>
+    void measure(const input& in, const char *library, const char *workload, size_t items, F&& run){
+        if(!wanted(in.name + "/" + library + "/" + workload)) return;
+        bool lookup = !strncmp(workload, "lookup", 6);
+        result r{in.name, library, workload, lookup ? 0 : in.text.size(), items, {}, 0, 0, 0};
+        for(int i = 0; i < opt.warmups; i++) sink += run();
+        reset_peak_rss();
+        size_t a = allocations, b = allocated_bytes;
+        sink += run();
+        r.allocations = allocations - a;
+        r.allocated_bytes = allocated_bytes - b;
+        double total = 0;
+        while((int)r.seconds.size() < opt.max_runs && ((int)r.seconds.size() < opt.min_runs || total < opt.min_time)){
+            auto start = std::chrono::steady_clock::now();
+            sink += run();
+            double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            r.seconds.push_back(s);
+            total += s;
+        }
+        r.peak_rss_kb = peak_rss_kb();
+        std::sort(r.seconds.begin(), r.seconds.end());
+        print(r);
+        results.push_back(std::move(r));
+    }
+    static void header(){
+        printf("%-10s %-10s %-10s %10s %8s %10s %9s %10s %10s\n", "input", "library", "workload",
+               "median ms", "stddev%", "MB/s", "ns/item", "allocs", "peak KB");
+    }
+    static void print(const result& r){
+        double m = r.median();
+        printf("%-10s %-10s %-10s %10.3f %8.1f %10.1f %9.2f %10zu %10zu\n", r.input.c_str(), r.library.c_str(),
+               r.workload.c_str(), m * 1e3, 100 * r.stddev() / r.mean(), r.bytes ? r.bytes / m / 1e6 : 0.0,
+               r.items ? m * 1e9 / r.items : 0.0, r.allocations, r.peak_rss_kb);
+        fflush(stdout);
+    }
+    void write_json() const {
+        if(opt.json_path.empty()) return;
+        std::ofstream out(opt.json_path);
+        out << "[\n";
+        for(size_t i = 0; i < results.size(); i++){
+            const result& r = results[i];
+            double m = r.median();
+            hex::json j = hex::json::make_obj({
+                {"input", r.input}, {"library", r.library}, {"workload", r.workload},
+                {"runs", (int64_t)r.seconds.size()}, {"bytes", (int64_t)r.bytes}, {"items", (int64_t)r.items},
+                {"min_ms", r.seconds.front() * 1e3}, {"median_ms", m * 1e3}, {"mean_ms", r.mean() * 1e3},
+                {"stddev_ms", r.stddev() * 1e3}, {"mb_per_s", r.bytes ? r.bytes / m / 1e6 : 0.0},
+                {"ns_per_item", r.items ? m * 1e9 / r.items : 0.0},
+                {"allocations", (int64_t)r.allocations}, {"allocated_bytes", (int64_t)r.allocated_bytes},
+                {"peak_rss_kb", (int64_t)r.peak_rss_kb}
+            });
+            out << "  " << j.dump() << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "]\n";
+    }
+};
+
+// Inputs
+// {{{
+static std::string read_file(const std::string& path){
+    std::ifstream in(path, std::ios::binary);
+    if(!in){
+        std::cerr << "Could not open " << path << "\n";
+        exit(EXIT_FAILURE);
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+/* About `size` bytes of integers and doubles of every length. */
+static std::string gen_numbers(size_t size){
+    std::mt19937_64 rng(1);
+    std::string s = "[";
+    char buf[32];
+    while(s.size() < size){
+        if(s.size() > 1) s += ',';
+        uint64_t r = rng();
+        char *end;
+        if(r & 1){
+            end = std::to_chars(buf, buf + sizeof buf, (int64_t)(r >> (r % 60)) * (r & 2 ? -1 : 1)).ptr;
+        } else {
+            double d = std::ldexp((double)(r >> 11), (int)(r % 80) - 90);
+            end = std::to_chars(buf, buf + sizeof buf, d).ptr;
+        }
+        s.append(buf, end);
+    }
+    return s + "]";
+}
+/* About `size` bytes of objects of strings: ASCII, UTF-8 and escapes, short and long. */
+static std::string gen_strings(size_t size){
+    static const char *const pieces[] = {"lorem", "ipsum", "dolor sit amet", "caf\xc3\xa9", "\xe6\x97\xa5\xe6\x9c\xac",
+                                         "\xf0\x9f\x98\x80", "\\n", "\\\"quoted\\\"", "\\u00e9", "\\ud83d\\ude00", "tab\\t"};
+    std::mt19937 rng(2);
+    std::string s = "[";
+    for(int i = 0; s.size() < size; i++){
+        if(s.size() > 1) s += ',';
+        s += "{\"id\":\"user" + std::to_string(i) + "\",\"name\":\"";
+        for(int w = 0, n = 1 + rng() % 3; w < n; w++) s += pieces[rng() % 11];
+        s += "\",\"text\":\"";
+        for(int w = 0, n = rng() % 40; w < n; w++){
+            s += pieces[rng() % 11];
+            s += ' ';
+        }
+        s += "\"}";
+    }
+    return s + "]";
+}
+/* About `size` bytes of arrays and objects nested `depth` deep, over and over. */
+static std::string gen_deep(size_t size, int depth){
+    std::string s = "[";
+    for(int i = 0; s.size() < size; i++){
+        if(s.size() > 1) s += ',';
+        for(int d = 0; d < depth; d++) s += d % 2 ? "{\"k\":" : "[" + std::to_string(d) + ",";
+        s += "null";
+        for(int d = depth - 1; d >= 0; d--) s += d % 2 ? "}" : "]";
+    }
+    return s + "]";
+}
+static size_t count_nodes(const hex::json& j){
+    size_t n = 1;
+    if(j.type == hex::ARRAY) for(const hex::json& e : j.as_arr()) n += count_nodes(e);
+    if(j.type == hex::OBJECT) for(const auto& m : j.as_obj()) n += count_nodes(m.second);
+    return n;
+}
+// }}}
+
+// Workloads
+// {{{
+/* Every key of every object, to look up again. */
+static void collect_keys(const hex::json& j, std::vector<std::pair<const hex::json*, std::string>>& out){
+    if(j.type == hex::ARRAY) for(const hex::json& e : j.as_arr()) collect_keys(e, out);
+    if(j.type == hex::OBJECT){
+        for(const auto& m : j.as_obj()){
+            out.emplace_back(&j, std::string(m.first.view()));
+            collect_keys(m.second, out);
+        }
+    }
+}
+static void bench_hex(suite& s, const input& in){
+    const char *begin = in.text.data(), *end = begin + in.text.size();
+    s.measure(in, "hex", "parse", in.nodes, [&]{
+        return hex::json::parse(begin, end).size();
+    });
+    s.measure(in, "hex", "parse_doc", in.nodes, [&]{
+        return hex::document::parse(begin, end).root().size();
+    });
+    hex::parser reused;
+    s.measure(in, "hex", "parse_reuse", in.nodes, [&]{
+        return reused.parse(begin, end).size();
+    });
+    hex::key_table table;
+    hex::parser interning;
+    interning.intern_keys(&table);
+    s.measure(in, "hex", "parse_keys", in.nodes, [&]{
+        return interning.parse(begin, end).size();
+    });
+    hex::json j = hex::json::parse(begin, end);
+    s.measure(in, "hex", "serialize", in.nodes, [&]{
+        return j.dump().size();
+    });
+    std::vector<std::pair<const hex::json*, std::string>> keys;
+    collect_keys(j, keys);
+    if(!keys.empty()){
+        s.measure(in, "hex", "lookup", keys.size(), [&]{
+            size_t found = 0;
+            for(auto& k : keys) found += k.first->as_obj().find(k.second) != k.first->as_obj().end();
+            return found;
+        });
+        // The same lookups in a tree parsed with a key table, with the keys interned up front.
+        const hex::json& doc = interning.parse(begin, end);
+        std::vector<std::pair<const hex::json*, std::string>> doc_keys;
+        collect_keys(doc, doc_keys);
+        std::vector<std::pair<const hex::json*, hex::interned_key>> interned;
+        for(auto& k : doc_keys) interned.emplace_back(k.first, table.intern(k.second));
+        s.measure(in, "hex", "lookup_keys", interned.size(), [&]{
+            size_t found = 0;
+            for(auto& k : interned) found += k.first->as_obj().find(k.second) != k.first->as_obj().end();
+            return found;
+        });
+    }
+    s.measure(in, "hex", "roundtrip", in.nodes, [&]{
+        return hex::json::parse(begin, end).dump().size();
+    });
+}
+#ifdef HEX_BENCH_NLOHMANN
+static void collect_keys(const nlohmann::json& j, std::vector<std::pair<const nlohmann::json*, std::string>>& out){
+    if(j.is_array()) for(const nlohmann::json& e : j) collect_keys(e, out);
+    if(j.is_object()){
+        for(auto it = j.begin(); it != j.end(); ++it){
+            out.emplace_back(&j, it.key());
+            collect_keys(it.value(), out);
+        }
+    }
+}
+static void bench_nlohmann(suite& s, const input& in){
+    s.measure(in, "nlohmann", "parse", in.nodes, [&]{
+        return nlohmann::json::parse(in.text).size();
+    });
+    nlohmann::json j = nlohmann::json::parse(in.text);
+    s.measure(in, "nlohmann", "serialize", in.nodes, [&]{
+        return j.dump().size();
+    });
+    std::vector<std::pair<const nlohmann::json*, std::string>> keys;
+    collect_keys(j, keys);
+    if(!keys.empty()){
+        s.measure(in, "nlohmann", "lookup", keys.size(), [&]{
+            size_t found = 0;
+            for(auto& k : keys) found += k.first->find(k.second) != k.first->end();
+            return found;
+        });
+    }
+    s.measure(in, "nlohmann", "roundtrip", in.nodes, [&]{
+        return nlohmann::json::parse(in.text).dump().size();
+    });
+}
+#endif
+#ifdef HEX_BENCH_RAPIDJSON
+static void collect_keys(const rapidjson::Value& v, std::vector<std::pair<const rapidjson::Value*, std::string>>& out){
+    if(v.IsArray()) for(const rapidjson::Value& e : v.GetArray()) collect_keys(e, out);
+    if(v.IsObject()){
+        for(const auto& m : v.GetObject()){
+            out.emplace_back(&v, std::string(m.name.GetString(), m.name.GetStringLength()));
+            collect_keys(m.value, out);
+        }
+    }
+}
+static std::string rapidjson_dump(const rapidjson::Document& d){
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+    d.Accept(writer);
+    return std::string(buf.GetString(), buf.GetSize());
+}
+static void bench_rapidjson(suite& s, const input& in){
+    s.measure(in, "rapidjson", "parse", in.nodes, [&]{
+        rapidjson::Document d;
+        d.Parse(in.text.data(), in.text.size());
+        return (size_t)d.HasParseError();
+    });
+    rapidjson::Document d;
+    d.Parse(in.text.data(), in.text.size());
+    s.measure(in, "rapidjson", "serialize", in.nodes, [&]{
+        return rapidjson_dump(d).size();
+    });
+    std::vector<std::pair<const rapidjson::Value*, std::string>> keys;
+    collect_keys(d, keys);
+    if(!keys.empty()){
+        s.measure(in, "rapidjson", "lookup", keys.size(), [&]{
+            size_t found = 0;
+            for(auto& k : keys){
+                rapidjson::Value name(rapidjson::StringRef(k.second.data(), k.second.size()));
+                found += k.first->FindMember(name) != k.first->MemberEnd();
+            }
+            return found;
+        });
+    }
+    s.measure(in, "rapidjson", "roundtrip", in.nodes, [&]{
+        rapidjson::Document doc;
+        doc.Parse(in.text.data(), in.text.size());
+        return rapidjson_dump(doc).size();
+    });
+}
+#endif
+// }}}
+
+int main(int argc, char *argv[]){
+    options opt;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--json" && i + 1 < argc){
+            opt.json_path = argv[++i];
+        } else if(arg == "--quick"){
+            opt.warmups = 1;
+            opt.min_runs = 3;
+            opt.min_time = 0.05;
+        } else if(arg.compare(0, 2, "--") == 0){
+            std::cerr << "Usage: " << argv[0] << " [--json results.json] [--quick] [filter...]\n";
+            return EXIT_FAILURE;
+        } else {
+            opt.filters.push_back(arg);
+        }
+    }
+    std::vector<input> inputs = {
+        {"canada", read_file(HEX_BENCH_DIR "/canada.json")},
+        {"citm", read_file(HEX_BENCH_DIR "/citm.json")},
+        {"numbers", gen_numbers(2 << 20)},
+        {"strings", gen_strings(2 << 20)},
+        {"deep", gen_deep(1 << 20, 500)},
+    };
+    suite s(opt);
+    suite::header();
+    for(input& in : inputs){
+        hex::json j = hex::json::parse(in.text);
+        if(j.invalid()){
+            std::cerr << in.name << " doesn't parse\n";
+            return EXIT_FAILURE;
+        }
+        in.nodes = count_nodes(j);
+        bench_hex(s, in);
+#ifdef HEX_BENCH_NLOHMANN
+        bench_nlohmann(s, in);
+#endif
+#ifdef HEX_BENCH_RAPIDJSON
+        bench_rapidjson(s, in);
+#endif
+    }
+    s.write_json();
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "../json.hpp"
+
+/* Number conversion speed: every number in a file (canada.json by default) read with
+ * strtod() and with the parser's number kernel, then the whole file through parse_sax().
+ * Each is run a few times and the best time is reported, in MB/s of number text. */
+
+struct ignore_all : hex::sax_handler {};
+
+template<typename F>
+double best_of(int runs, F&& f){
+    double best = 1e30;
+    for(int i = 0; i < runs; i++){
+        auto start = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]){
+    hex::mapped_file file(argc > 1 ? argv[1] : "benchmark/canada.json");
+    // Numbers start at a digit or '-' outside of strings (no string in these files has either).
+    std::vector<std::pair<const char*, const char*>> numbers;
+    size_t bytes = 0;
+    bool in_string = false;
+    for(const char *p = file.begin(); p != file.end(); p++){
+        if(*p == '"') in_string = !in_string;
+        if(in_string || !(*p == '-' || ('0' <= *p && *p <= '9'))) continue;
+        const char *start = p;
+        while(p != file.end() && (hex::json::is_digit(*p) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) p++;
+        numbers.emplace_back(start, p);
+        bytes += p - start;
+        p--;
+    }
+    volatile double sink = 0;
+    double t_strtod = best_of(10, [&]{
+        double sum = 0;
+        std::string copy;
+        for(auto& n : numbers){
+            // strtod needs a terminator after the number.
+            copy.assign(n.first, n.second);
+            sum += strtod(copy.c_str(), nullptr);
+        }
+        sink = sum;
+    });
+    double t_kernel = best_of(10, [&]{
+        double sum = 0;
+        for(auto& n : numbers){
+            bool decimal;
+            int64_t i;
+            double d;
+            hex::json::read_number(n.first, n.second, decimal, i, d);
+            sum += decimal ? d : i;
+        }
+        sink = sum;
+    });
+    double t_sax = best_of(10, [&]{
+        ignore_all h;
+        hex::json::parse_sax(file.begin(), file.end(), h);
+    });
+    std::cout << numbers.size() << " numbers, " << bytes / 1e6 << " MB of number text\n";
+    std::cout << "strtod:        " << bytes / t_strtod / 1e6 << " MB/s\n";
+    std::cout << "number kernel: " << bytes / t_kernel / 1e6 << " MB/s\n";
+    std::cout << "parse_sax:     " << file.size() / t_sax / 1e6 << " MB/s (whole file)\n";
+}
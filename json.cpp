@@ -3,6 +3,7 @@
 #include <chrono>
 #include <fstream>
 #include <iterator>
+// The stats mode needs the stats hooks, which slow down every parse: build it with -DHEX_JSON_STATS.
 #include "json.hpp"
 
 void test(int line, bool cond, bool ok){
@@ -18,43 +19,59 @@ void test(int line, bool cond, bool ok){
 /* Tests the JSON library. */
 int main(int argc, char *argv[]){
     std::string arg(argc == 2 || argc == 3 ? argv[1] : "");
-    if(!((argc == 2 && (arg == "automated" || arg == "manual"))
-        || (argc == 3 && arg == "manual"))){
-        std::cerr << "Usage: " << argv[0] << " automated|manual <file>\n";
+    if(!((argc == 2 && (arg == "automated" || arg == "manual" || arg == "stats"))
+        || (argc == 3 && (arg == "manual" || arg == "stats")))){
+        std::cerr << "Usage: " << argv[0] << " automated|manual|stats <file>\n";
         return EXIT_FAILURE;
     }
-    if(arg == "manual"){
+#ifndef HEX_JSON_STATS
+    if(arg == "stats"){
+        std::cerr << "Built without the stats hooks, rebuild with -DHEX_JSON_STATS.\n";
+        return EXIT_FAILURE;
+    }
+#endif
+    if(arg == "manual" || arg == "stats"){
         std::string input;
+        hex::mapped_file file;
         if(argc == 3){
-            std::ifstream in(argv[2], std::ios::in | std::ios::binary);
-            if(!in){
+            try {
+                file = hex::mapped_file(argv[2]);
+            } catch(const std::system_error& e){
                 std::cerr << "Could not open file!\n";
                 return EXIT_FAILURE;
             }
-            in.seekg(0, std::ios::end);
-            input.resize(in.tellg());
-            in.seekg(0, std::ios::beg);
-            in.read(&input[0], input.size());
-            in.close();
         } else {
-            // don't skip the whitespace while reading
-              std::cin >> std::noskipws;
-            // use stream iterators to copy the stream to a string
-              std::istream_iterator<char> it(std::cin);
-              std::istream_iterator<char> end;
-              std::string results(it, end);
-              input = results;
+            // Read stdin in big pieces, not character by character.
+            char buf[1 << 16];
+            while(std::cin.read(buf, sizeof buf) || std::cin.gcount()){
+                input.append(buf, std::cin.gcount());
+            }
+        }
+        const char *begin = argc == 3 ? file.begin() : input.data();
+        const char *end = argc == 3 ? file.end() : input.data() + input.size();
+        hex::json j(hex::INVALID_ITEM);
+#ifdef HEX_JSON_STATS
+        hex::parse_stats stats;
+        if(arg == "stats"){
+            hex::stats_scope scope(stats);
+            j = hex::json::parse(begin, end);
+        } else
+#endif
+        {
+            auto starttime = std::chrono::high_resolution_clock::now();
+            j = hex::json::parse(begin, end);
+            double duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now()-starttime).count();
+            std::cout << (long long)(duration/1000000) << "ms\n";
         }
-        auto starttime = std::chrono::high_resolution_clock::now();
-        hex::json j = hex::json::parse(input);
-        double duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now()-starttime).count();
-        std::cout << (long long)(duration/1000000) << "ms\n";
 
         if(j.invalid()){
             std::cout << "Item is invalid!\n";
-            std::cout << "At index " << (j.val.invalid_end - input.c_str()) << "\n";
+            std::cout << "At index " << (j.val.invalid_end - begin) << "\n";
             return EXIT_FAILURE;
         }
+#ifdef HEX_JSON_STATS
+        if(arg == "stats") stats.report(std::cout);
+#endif
         // std::cout << j.dump() << '\n';
     } else if(arg == "automated"){
         //TODO: add tests
@@ -3,8 +3,47 @@
 
 #include <iostream>
 #include <vector>
-#include <map>
+#include <algorithm>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <cstring>
+#include <cstddef>
 #include <charconv>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <atomic>
+#include <tuple>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <limits>
+#include <type_traits>
+#include <cstdio>
+#include <chrono>
+#if defined(__unix__) || defined(__APPLE__)
+#define HEX_JSON_POSIX 1
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <climits>
+#include <cerrno>
+#endif
+#include <cmath>
+#include <cfloat>
+#include <system_error>
+#if defined(__x86_64__) || defined(__i386__)
+#define HEX_JSON_X86 1
+#include <immintrin.h>
+#endif
 
 #ifdef DEBUG
 #define dbg std::cerr
@@ -13,6 +52,583 @@
 #endif
 
 namespace hex {
+    /* A monotonic arena.
+     * Memory is handed out by bumping a pointer through blocks that double in size,
+     * and is only given back all at once, when the arena is released or destroyed, or reused
+     * from the start after reset().
+     * It is a std::pmr::memory_resource, so standard containers can live in it too.
+     * Blocks are registered while they're held, so owner() can tell which arena an address is in.
+     */
+    class arena : public std::pmr::memory_resource {
+        struct block {
+            block *prev;
+            size_t size;
+        };
+        /* Every block held by an arena: where it starts, where it ends and whose it is. */
+        struct registry {
+            std::mutex m;
+            std::map<uintptr_t, std::pair<uintptr_t, arena*>> blocks;
+        };
+        static registry& blocks() noexcept {
+            // Never destroyed, so arenas destroyed late at exit can still take their blocks out.
+            static registry *r = new registry;
+            return *r;
+        }
+        static inline std::atomic<size_t> held{0};
+        block *head = nullptr;
+        char *curr = nullptr, *lim = nullptr;
+        size_t next_size;
+
+        void grow(size_t bytes, size_t align){
+            size_t size = next_size;
+            while(size < bytes + align + sizeof(block)) size *= 2;
+            block *b = static_cast<block*>(::operator new(size));
+            try {
+                registry& r = blocks();
+                std::lock_guard<std::mutex> lock(r.m);
+                uintptr_t start = reinterpret_cast<uintptr_t>(b);
+                r.blocks.emplace(start, std::make_pair(start + size, this));
+                held.fetch_add(1, std::memory_order_relaxed);
+            } catch(...){
+                ::operator delete(b);
+                throw;
+            }
+            b->prev = head;
+            b->size = size;
+            head = b;
+            curr = reinterpret_cast<char*>(b + 1);
+            lim = reinterpret_cast<char*>(b) + size;
+            next_size = size * 2;
+        }
+        void *do_allocate(size_t bytes, size_t align) override {
+            uintptr_t p = (reinterpret_cast<uintptr_t>(curr) + align - 1) & ~(uintptr_t)(align - 1);
+            if(curr == nullptr || p + bytes > reinterpret_cast<uintptr_t>(lim)){
+                grow(bytes, align);
+                p = (reinterpret_cast<uintptr_t>(curr) + align - 1) & ~(uintptr_t)(align - 1);
+            }
+            curr = reinterpret_cast<char*>(p + bytes);
+            return reinterpret_cast<void*>(p);
+        }
+        /* Individual frees are no-ops, that's the point. */
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override {
+            return this == &rhs;
+        }
+        public:
+        explicit arena(size_t initial_size = 4096) : next_size(initial_size < 256 ? 256 : initial_size) {}
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+        ~arena() noexcept {
+            release();
+        }
+        /* Frees every block. Everything allocated from the arena is gone after this. */
+        void release() noexcept {
+            if(!head) return;
+            registry& r = blocks();
+            std::lock_guard<std::mutex> lock(r.m);
+            while(head){
+                block *prev = head->prev;
+                r.blocks.erase(reinterpret_cast<uintptr_t>(head));
+                held.fetch_sub(1, std::memory_order_relaxed);
+                ::operator delete(head);
+                head = prev;
+            }
+            curr = lim = nullptr;
+        }
+        /* The arena holding the block `p` is in, or nullptr if it isn't in one. */
+        static arena *owner(const void *p) noexcept {
+            if(!held.load(std::memory_order_relaxed)) return nullptr;
+            registry& r = blocks();
+            uintptr_t at = reinterpret_cast<uintptr_t>(p);
+            std::lock_guard<std::mutex> lock(r.m);
+            auto it = r.blocks.upper_bound(at);
+            if(it == r.blocks.begin()) return nullptr;
+            --it;
+            return at < it->second.first ? it->second.second : nullptr;
+        }
+        /* Forgets everything allocated from the arena, but keeps its memory for what comes next.
+         * If it took several blocks, they're swapped for one as large as all of them together,
+         * so the same amount of allocation fits in it the next time.
+         */
+        void reset() noexcept {
+            if(head && head->prev){
+                size_t total = 0;
+                for(block *b = head; b; b = b->prev) total += b->size;
+                release();
+                next_size = total;
+                return;
+            }
+            if(head){
+                curr = reinterpret_cast<char*>(head + 1);
+                lim = reinterpret_cast<char*>(head) + head->size;
+            }
+        }
+        /* Bytes held in blocks. */
+        size_t capacity() const noexcept {
+            size_t total = 0;
+            for(block *b = head; b; b = b->prev) total += b->size;
+            return total;
+        }
+    };
+
+    /* Stage 1 of parsing: finds where every token starts, so the parser never has to look at
+     * whitespace or the inside of strings byte by byte.
+     * The input is classified 64 bytes at a time (with AVX2 or SSE2 when the CPU has them, picked at
+     * runtime) into bitmasks of quotes, backslashes, whitespace and structural characters. From those
+     * it works out which quotes are escaped and which bytes are inside strings, and records the offset of:
+     *  - every { } [ ] : , outside of strings,
+     *  - both quotes of every string,
+     *  - the first byte of every other scalar (numbers, true, false, null, and garbage).
+     * It's built a window at a time as the parser asks for tokens, so its memory doesn't grow
+     * with the input. After the last token, next() keeps returning `end` as a sentinel.
+     */
+    class structural_index {
+        struct block_masks {
+            uint64_t quote, backslash, space, op;
+        };
+
+        static block_masks classify_scalar(const char *p){
+            block_masks m = {0, 0, 0, 0};
+            for(int i = 0; i < 64; i++){
+                char c = p[i];
+                uint64_t bit = (uint64_t)1 << i;
+                if(c == '"') m.quote |= bit;
+                else if(c == '\\') m.backslash |= bit;
+                else if(c == ' ' || c == '\t' || c == '\n' || c == '\r') m.space |= bit;
+                else if(c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') m.op |= bit;
+            }
+            return m;
+        }
+#ifdef HEX_JSON_X86
+        /* '[' and ']' are '{' and '}' with bit 0x20 cleared, so or-ing it in catches all four brackets. */
+        static block_masks classify_sse2(const char *p){
+            block_masks m = {0, 0, 0, 0};
+            for(int i = 0; i < 4; i++){
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+                __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+                __m128i space = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+                __m128i op = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+                int shift = 16 * i;
+                m.quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+                m.backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+                m.space |= (uint64_t)(uint16_t)_mm_movemask_epi8(space) << shift;
+                m.op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+            }
+            return m;
+        }
+        __attribute__((target("avx2")))
+        static block_masks classify_avx2(const char *p){
+            block_masks m = {0, 0, 0, 0};
+            for(int i = 0; i < 2; i++){
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+                __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+                __m256i space = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+                __m256i op = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+                int shift = 32 * i;
+                m.quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << shift;
+                m.backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << shift;
+                m.space |= (uint64_t)(uint32_t)_mm256_movemask_epi8(space) << shift;
+                m.op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+            }
+            return m;
+        }
+#endif
+        typedef block_masks (*classifier)(const char*);
+        /* Picked once, the first time anything is indexed. */
+        static classifier pick_classifier(){
+#ifdef HEX_JSON_X86
+            if(__builtin_cpu_supports("avx2")) return classify_avx2;
+            return classify_sse2;
+#else
+            return classify_scalar;
+#endif
+        }
+
+        /* State carried from one block to the next. */
+        uint64_t escape_carry = 0;      // 1 if the last block ended with an unescaped backslash
+        uint64_t string_carry = 0;      // all ones if the last block ended inside a string
+        uint64_t scalar_carry = 0;      // 1 if the last block ended in the middle of a scalar
+        size_t count = 0;
+
+        /* Marks the bytes that are escaped by a backslash. Backslashes are rare, so just walk them. */
+        inline uint64_t find_escaped(uint64_t backslash){
+            uint64_t escaped = escape_carry;
+            escape_carry = 0;
+            while(backslash){
+                int i = __builtin_ctzll(backslash);
+                backslash &= backslash - 1;
+                if(escaped >> i & 1) continue;
+                if(i == 63) escape_carry = 1;
+                else escaped |= (uint64_t)1 << (i + 1);
+            }
+            return escaped;
+        }
+#ifdef HEX_JSON_X86
+        /* For every byte of bits, the positions of the set bits, for pshufb to pack those bytes together. */
+        struct pack_table {
+            uint8_t shuffle[256][8];
+            constexpr pack_table() : shuffle() {
+                for(int k = 0; k < 256; k++){
+                    int n = 0;
+                    for(int j = 0; j < 8; j++) if(k >> j & 1) shuffle[k][n++] = j;
+                    for(; n < 8; n++) shuffle[k][n] = 0x80;
+                }
+            }
+        };
+        /* emit() for a whole block, 8 bytes at a time. Each store is 8 bytes wide, at the number of
+         * bytes kept before it, which still never gets ahead of the input. Those offsets don't
+         * depend on each other, so the stores don't wait on one another. */
+        __attribute__((target("ssse3,popcnt")))
+        static char *emit_ssse3(char *out, const char *bytes, uint64_t keep){
+            static constexpr pack_table table;
+            for(int i = 0; i < 64; i += 8){
+                uint8_t k = keep >> i;
+                __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes + i));
+                __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(table.shuffle[k]));
+                size_t before = __builtin_popcountll(keep & (((uint64_t)1 << i) - 1));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + before), _mm_shuffle_epi8(v, s));
+            }
+            return out + __builtin_popcountll(keep);
+        }
+#endif
+        /* Appends the bytes of a block whose bits are set in `keep` to `minified`.
+         * Every byte is stored and the pointer only moves past the kept ones, so there's no branch
+         * per byte. Only the first `size` bytes of the block are input (the last block can be
+         * shorter), and nothing past them is stored, so the stores never get ahead of the input
+         * and the output needs no slack. */
+        inline void emit(const char *bytes, uint64_t keep, int size){
+            char *out = minified;
+            if(keep == ~(uint64_t)0){
+                memcpy(out, bytes, 64);
+                minified = out + 64;
+                return;
+            }
+#ifdef HEX_JSON_X86
+            static const bool ssse3 = __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt");
+            if(ssse3 && size == 64){
+                minified = emit_ssse3(out, bytes, keep);
+                return;
+            }
+#endif
+            for(int i = 0; keep; i += 8, keep >>= 8){
+                uint8_t k = keep;
+                if(k == 0xff){
+                    memcpy(out, bytes + i, 8);
+                    out += 8;
+                    continue;
+                }
+                if(!k) continue;
+                for(int j = 0, n = std::min(8, size - i); j < n; j++){
+                    *out = bytes[i + j];
+                    out += k >> j & 1;
+                }
+            }
+            minified = out;
+        }
+        inline void add_block(const block_masks& m, uint32_t offset, const char *bytes, int size = 64){
+            uint64_t quote = m.quote & ~find_escaped(m.backslash);
+            // Prefix xor: bit i is set if there's an odd number of quotes up to and including i,
+            // which is everything from an opening quote up to (not including) its closing quote.
+            uint64_t in_string = quote;
+            in_string ^= in_string << 1;
+            in_string ^= in_string << 2;
+            in_string ^= in_string << 4;
+            in_string ^= in_string << 8;
+            in_string ^= in_string << 16;
+            in_string ^= in_string << 32;
+            in_string ^= string_carry;
+            string_carry = (uint64_t)((int64_t)in_string >> 63);
+            uint64_t scalar = ~(m.op | m.space | quote | in_string);
+            uint64_t scalar_start = scalar & ~((scalar << 1) | scalar_carry);
+            scalar_carry = scalar >> 63;
+            uint64_t bits = (m.op & ~in_string) | quote | scalar_start;
+            uint32_t *out = tokens.data() + count;
+            while(bits){
+                *out++ = offset + __builtin_ctzll(bits);
+                bits &= bits - 1;
+            }
+            count = out - tokens.data();
+            if(minified){
+                uint64_t valid = size == 64 ? ~(uint64_t)0 : ((uint64_t)1 << size) - 1;
+                emit(bytes, ~(m.space & ~in_string) & valid, size);
+            }
+        }
+
+        const char *input = nullptr, *end = nullptr;
+        size_t pos = 0;                 // next byte to index
+        size_t window;
+        std::vector<uint32_t> tokens;   // offsets from `base` of the tokens in the current window
+        const char *base = nullptr;
+        const uint32_t *tok = nullptr, *stop = nullptr;
+        char *minified = nullptr;       // where the input goes without whitespace, if anywhere
+
+        /* Indexes the next window. Every block can hold at most 64 tokens, so `tokens` never grows. */
+        void refill(){
+            static const classifier classify = pick_classifier();
+            size_t length = end - input;
+            size_t limit = std::min(length, pos + window);
+            base = input + pos;
+            count = 0;
+            for(; pos + 64 <= limit; pos += 64){
+                add_block(classify(input + pos), input + pos - base, input + pos);
+            }
+            if(limit == length){
+                if(pos < length){
+                    // Pad the last block with spaces instead of reading past the end.
+                    char last[64];
+                    memset(last, ' ', 64);
+                    memcpy(last, input + pos, length - pos);
+                    add_block(classify(last), input + pos - base, last, length - pos);
+                    pos = length;
+                }
+                tokens[count++] = end - base;
+            }
+            tok = tokens.data();
+            stop = tok + count;
+        }
+
+        public:
+        static constexpr size_t default_window = 1 << 15;
+        /* What an index for [input, end) needs: a default window, or less for a small input. */
+        static size_t window_for(const char *input, const char *end){
+            return std::min<size_t>(default_window, end - input + 64);
+        }
+
+        explicit structural_index(size_t window = default_window) : window(std::max<size_t>(64, window / 64 * 64)) {
+            tokens.resize(this->window + 1);
+        }
+        structural_index(const char *input, const char *end, size_t window = default_window) : structural_index(window) {
+            reset(input, end);
+        }
+        inline size_t window_size() const noexcept {
+            return window;
+        }
+        /* Starts over on [input, end). Nothing past `end` is ever read.
+         * With `minified`, every byte indexed that isn't whitespace outside of a string is also
+         * copied there, which needs room for the whole input (see hex::minify()). */
+        void reset(const char *input, const char *end, char *minified = nullptr){
+            this->input = input;
+            this->end = end;
+            this->minified = minified;
+            pos = 0;
+            escape_carry = string_carry = scalar_carry = 0;
+            tok = stop = nullptr;
+        }
+        /* The end of what's been copied to `minified`. */
+        inline char *minified_end() const noexcept {
+            return minified;
+        }
+        /* The start of the next token (or `end`), consuming it. */
+        inline const char *next(){
+            // A window can be all whitespace.
+            while(tok == stop) refill();
+            return base + *tok++;
+        }
+        /* The start of the next token (or `end`), without consuming it. */
+        inline const char *peek(){
+            while(tok == stop) refill();
+            return base + *tok;
+        }
+    };
+
+    /* A work-stealing thread pool.
+     * Every worker has its own queue. submit() hands tasks out round-robin, workers run their own
+     * tasks oldest first and, once they run dry, steal the newest task of another worker, so
+     * uneven tasks still keep every core busy. A thread waiting on results can help with run_one().
+     */
+    class thread_pool {
+        struct queue {
+            std::mutex m;
+            std::deque<std::function<void()>> tasks;
+        };
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> workers;
+        std::mutex m;
+        std::condition_variable wake;
+        std::atomic<size_t> queued{0};
+        size_t next_queue = 0;
+        bool stopping = false;
+
+        /* Takes a task, starting with queue `self`. */
+        bool pop(size_t self, std::function<void()>& task){
+            for(size_t i = 0; i < queues.size(); i++){
+                queue& q = *queues[(self + i) % queues.size()];
+                std::lock_guard<std::mutex> lock(q.m);
+                if(q.tasks.empty()) continue;
+                if(i == 0){
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                } else {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                }
+                queued--;
+                return true;
+            }
+            return false;
+        }
+        void work(size_t self){
+            std::function<void()> task;
+            for(;;){
+                if(pop(self, task)){
+                    task();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(m);
+                wake.wait(lock, [this]{ return stopping || queued > 0; });
+                if(stopping && queued == 0) return;
+            }
+        }
+        public:
+        /* 0 threads means one per core. */
+        explicit thread_pool(size_t threads = 0){
+            if(!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+            for(size_t i = 0; i < threads; i++) queues.emplace_back(new queue);
+            for(size_t i = 0; i < threads; i++) workers.emplace_back([this, i]{ work(i); });
+        }
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        /* Runs whatever was already submitted, then stops. */
+        ~thread_pool(){
+            {
+                std::lock_guard<std::mutex> lock(m);
+                stopping = true;
+            }
+            wake.notify_all();
+            for(std::thread& t : workers) t.join();
+        }
+        inline size_t size() const noexcept {
+            return workers.size();
+        }
+        void submit(std::function<void()> task){
+            size_t i;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                i = next_queue++ % queues.size();
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues[i]->m);
+                queues[i]->tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(m);
+                queued++;
+            }
+            wake.notify_one();
+        }
+        /* Runs one queued task on the calling thread, if there is one. */
+        bool run_one(){
+            std::function<void()> task;
+            if(!pop(0, task)) return false;
+            task();
+            return true;
+        }
+        /* A pool with one thread per core, started the first time it's needed. */
+        static thread_pool& shared(){
+            static thread_pool pool;
+            return pool;
+        }
+    };
+
+    /* A whole file, read-only, for parsing straight out of.
+     * On POSIX systems the file is mmap()ed (and the kernel told it will be read sequentially),
+     * so nothing is copied and pages are only read in as the parser gets to them. Elsewhere it's
+     * read into memory. Throws std::system_error if the file can't be opened or mapped.
+     * Nothing after the last byte is ever read, so no padding is needed.
+     */
+    class mapped_file {
+        const char *ptr = nullptr;
+        size_t len = 0;
+#ifndef HEX_JSON_POSIX
+        std::string contents;
+#endif
+        public:
+        /* Empty, nothing mapped. */
+        mapped_file() = default;
+        explicit mapped_file(const char *path){
+#ifdef HEX_JSON_POSIX
+            int fd = ::open(path, O_RDONLY);
+            if(fd < 0) throw std::system_error(errno, std::generic_category(), path);
+            struct stat st;
+            if(fstat(fd, &st) < 0){
+                int err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), path);
+            }
+            len = st.st_size;
+            if(len){
+                void *p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(p == MAP_FAILED){
+                    int err = errno;
+                    ::close(fd);
+                    throw std::system_error(err, std::generic_category(), path);
+                }
+                madvise(p, len, MADV_SEQUENTIAL);
+                ptr = static_cast<const char*>(p);
+            }
+            // The mapping stays valid without the descriptor.
+            ::close(fd);
+#else
+            FILE *f = fopen(path, "rb");
+            if(!f) throw std::system_error(errno, std::generic_category(), path);
+            char buf[1 << 16];
+            while(size_t n = fread(buf, 1, sizeof buf, f)) contents.append(buf, n);
+            fclose(f);
+            ptr = contents.data();
+            len = contents.size();
+#endif
+        }
+        explicit mapped_file(const std::string& path) : mapped_file(path.c_str()) {}
+        mapped_file(mapped_file&& rhs) noexcept : ptr(rhs.ptr), len(rhs.len)
+#ifndef HEX_JSON_POSIX
+            , contents(std::move(rhs.contents))
+#endif
+        {
+#ifndef HEX_JSON_POSIX
+            ptr = contents.data();
+#endif
+            rhs.ptr = nullptr;
+            rhs.len = 0;
+        }
+        mapped_file& operator=(mapped_file&& rhs) noexcept {
+            std::swap(ptr, rhs.ptr);
+            std::swap(len, rhs.len);
+#ifndef HEX_JSON_POSIX
+            contents.swap(rhs.contents);
+            ptr = contents.data();
+            rhs.ptr = rhs.contents.data();
+#endif
+            return *this;
+        }
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+        ~mapped_file() noexcept {
+#ifdef HEX_JSON_POSIX
+            if(ptr) munmap(const_cast<char*>(ptr), len);
+#endif
+        }
+        inline const char *data() const noexcept {
+            return ptr;
+        }
+        inline size_t size() const noexcept {
+            return len;
+        }
+        inline const char *begin() const noexcept {
+            return ptr;
+        }
+        inline const char *end() const noexcept {
+            return ptr + len;
+        }
+    };
+
     /* JSON types as described in the RFC. */
     typedef uint8_t val_type;
     val_type
@@ -24,576 +640,5414 @@ namespace hex {
         ARRAY = 6,
         OBJECT = 7,
         INVALID_ITEM = 0;
-    class json;
-    typedef std::map<std::string, json> table;
-    typedef std::vector<json> array_t;
-    union value {
-        double decimal;
-        int64_t integer;
-        table *object;
-        array_t *array;
-        std::string *str;
-        bool boolean;
-        const char *invalid_end;
+    /* Why parsing failed: the input isn't JSON, it nests deeper than the parser's limit, or a
+     * handler returned false. */
+    typedef uint8_t parse_error;
+    constexpr parse_error PARSE_OK = 0, SYNTAX_ERROR = 1, TOO_DEEP = 2, STOPPED = 3;
+
+#ifdef HEX_JSON_STATS
+    /* What parsing did, to size buffers and arenas for real traffic and to see where the time goes.
+     * Only there if HEX_JSON_STATS is defined before including this file; otherwise the hooks in
+     * the parser are empty macros. Parses add to the stats of the stats_scope alive on their thread,
+     * so one parse_stats can sum up many of them.
+     */
+    struct parse_stats {
+        size_t bytes = 0;               // input handed to the grammar
+        size_t values[8] = {};          // by val_type
+        size_t keys = 0;
+        size_t max_depth = 0;
+        size_t string_bytes = 0;        // raw bytes of strings and keys, without the quotes
+        size_t escapes = 0;
+        /* Allocations of nodes, blocks, long strings and keys (any made on the thread while the
+         * scope is alive, parsing or not). With an arena, these are what's asked of the arena. */
+        size_t allocations = 0;
+        size_t allocated_bytes = 0;
+        /* Nanoseconds spent validating and decoding strings and keys, converting numbers, in the
+         * handler's callbacks (building the tree, for parse()), and everything else: indexing the
+         * input and walking the grammar. */
+        double string_ns = 0, number_ns = 0, build_ns = 0, scan_ns = 0;
+
+        enum phase { STRINGS, NUMBERS, BUILD };
+        uint64_t ticks[3] = {};
+        static inline thread_local parse_stats *current = nullptr;
+        /* Phases are timed in whatever's cheapest to read, and turned into nanoseconds once the
+         * whole parse is over. */
+        static inline uint64_t now() noexcept {
+#ifdef HEX_JSON_X86
+            return __rdtsc();
+#else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+        /* Adds the time until it's destroyed to a phase. */
+        class timer {
+            uint64_t *slot;
+            uint64_t start;
+            public:
+            timer(phase p) noexcept : slot(current ? &current->ticks[p] : nullptr), start(slot ? now() : 0) {}
+            ~timer(){
+                if(slot) *slot += now() - start;
+            }
+        };
+        /* One whole parse of `bytes` bytes. */
+        class session {
+            parse_stats *s;
+            uint64_t start;
+            uint64_t before[3];
+            std::chrono::steady_clock::time_point wall;
+            public:
+            session(size_t bytes) noexcept : s(current) {
+                if(!s) return;
+                s->bytes += bytes;
+                memcpy(before, s->ticks, sizeof before);
+                wall = std::chrono::steady_clock::now();
+                start = now();
+            }
+            ~session(){
+                if(!s) return;
+                uint64_t ticks = now() - start;
+                double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wall).count();
+                double per_tick = ticks ? ns / ticks : 0;
+                double phases[3];
+                for(int i = 0; i < 3; i++) phases[i] = (s->ticks[i] - before[i]) * per_tick;
+                s->string_ns += phases[STRINGS];
+                s->number_ns += phases[NUMBERS];
+                s->build_ns += phases[BUILD];
+                s->scan_ns += std::max(0.0, ns - phases[STRINGS] - phases[NUMBERS] - phases[BUILD]);
+            }
+        };
+
+        void report(std::ostream& out) const {
+            static const char *const names[8] = {"invalid", "nulls", "decimals", "integers", "strings",
+                                                 "booleans", "arrays", "objects"};
+            size_t nodes = 0;
+            for(size_t n : values) nodes += n;
+            double total = scan_ns + string_ns + number_ns + build_ns;
+            auto line = [&](const char *name, size_t value){
+                out << "  " << name << std::string(16 - strlen(name), ' ') << value << '\n';
+            };
+            auto time = [&](const char *name, double ns){
+                out << "  " << name << std::string(16 - strlen(name), ' ') << ns / 1e6 << " ms ("
+                    << (total ? 100 * ns / total : 0) << "%)\n";
+            };
+            out << "input:\n";
+            line("bytes", bytes);
+            line("values", nodes);
+            for(int t = 7; t > 0; t--) line(names[t], values[t]);
+            line("keys", keys);
+            line("max depth", max_depth);
+            line("string bytes", string_bytes);
+            line("escapes", escapes);
+            out << "memory:\n";
+            line("allocations", allocations);
+            line("bytes", allocated_bytes);
+            out << "time:\n";
+            out << "  total           " << total / 1e6 << " ms";
+            if(total) out << " (" << bytes / (total / 1e9) / 1e6 << " MB/s, " << (nodes ? total / nodes : 0) << " ns/value)";
+            out << '\n';
+            time("scanning", scan_ns);
+            time("strings", string_ns);
+            time("numbers", number_ns);
+            time("building", build_ns);
+        }
     };
-    class json {
+    /* Makes parses on this thread add to `stats` while it's alive. Scopes nest. */
+    class stats_scope {
+        parse_stats *prev;
         public:
-        value val;
-        val_type type;
-        // constructors and destructors
-        // {{{
-        json(const json& rhs){
-            type = rhs.type;
-            if(type == OBJECT) val.object = new table(*rhs.val.object);
-            else if(type == ARRAY){
-                val.array = new array_t(*rhs.val.array);
+        explicit stats_scope(parse_stats& stats) noexcept : prev(parse_stats::current) {
+            parse_stats::current = &stats;
+        }
+        ~stats_scope(){
+            parse_stats::current = prev;
+        }
+        stats_scope(const stats_scope&) = delete;
+        stats_scope& operator=(const stats_scope&) = delete;
+    };
+/* Runs the statements with `stats` pointing at the current parse_stats, if there is one. */
+#define HEX_JSON_STAT(...) do { \
+    if(hex::parse_stats *stats = hex::parse_stats::current){ __VA_ARGS__; } \
+} while(0)
+/* Adds the rest of the enclosing block to a phase. */
+#define HEX_JSON_TIME(p) hex::parse_stats::timer hex_json_timer(hex::parse_stats::p)
+#define HEX_JSON_SESSION(bytes) hex::parse_stats::session hex_json_session(bytes)
+#else
+#define HEX_JSON_STAT(...) do {} while(0)
+#define HEX_JSON_TIME(p) do {} while(0)
+#define HEX_JSON_SESSION(bytes) do {} while(0)
+#endif
+    /* An object key.
+     * Keys up to 15 bytes are stored inline. Longer ones either own a copy allocated from their
+     * object's resource, or borrow bytes that outlive the object (in-situ documents, key_table).
+     * Unused bytes are zero, so two keys with the same 16 bytes are always equal.
+     */
+    class key {
+        /* Inline: the bytes, then the length in the low nibble of bytes[15].
+         * Otherwise: a pointer at bytes[0..8), the length at bytes[8..12) and the kind in the
+         * high nibble of bytes[15]. */
+        alignas(8) char bytes[16];
+        inline uint8_t kind() const noexcept {
+            return (uint8_t)bytes[15] >> 4;
+        }
+        inline const char *ptr() const noexcept {
+            const char *p;
+            memcpy(&p, bytes, sizeof p);
+            return p;
+        }
+        inline uint32_t len() const noexcept {
+            uint32_t n;
+            memcpy(&n, bytes + 8, sizeof n);
+            return n;
+        }
+        public:
+        static constexpr size_t inline_size = 15;
+        static constexpr uint8_t INLINE = 0, OWNED = 1, BORROWED = 2;
+        key() noexcept {
+            bytes[15] = 0;
+        }
+        static uint64_t hash(std::string_view s) noexcept {
+            const char *p = s.data();
+            size_t n = s.size();
+            uint64_t h = 0x9e3779b97f4a7c15ull ^ n;
+            for(; n >= 8; p += 8, n -= 8){
+                uint64_t w;
+                memcpy(&w, p, 8);
+                h = (h ^ w) * 0xff51afd7ed558ccdull;
+                h ^= h >> 32;
             }
-            else if(type == STRING) val.str = new std::string(*rhs.val.str);
-            else val = rhs.val;
+            uint64_t w = 0;
+            memcpy(&w, p, n);
+            h = (h ^ w) * 0xc4ceb9fe1a85ec53ull;
+            return h ^ (h >> 29);
         }
-        json(json&& rhs) noexcept {
-            type = rhs.type;
-            /* Move constructor, more like pilfer constructor. */
-            val = rhs.val;
-            if(rhs.type == OBJECT) rhs.val.object = nullptr;
-            if(rhs.type == ARRAY) rhs.val.array = nullptr;
-            if(rhs.type == STRING) rhs.val.str = nullptr;
-            rhs.type = INVALID_ITEM;
+        /* Keys are plain bytes: copying one doesn't copy what it points to, see assign(). */
+        void assign(std::string_view s, std::pmr::memory_resource *mr, bool borrow){
+            memset(bytes, 0, sizeof bytes);
+            if(s.size() <= inline_size){
+                memcpy(bytes, s.data(), s.size());
+                bytes[15] = s.size();
+                return;
+            }
+            const char *p = s.data();
+            if(!borrow){
+                HEX_JSON_STAT(stats->allocations++, stats->allocated_bytes += s.size());
+                char *copy = static_cast<char*>(mr->allocate(s.size(), 1));
+                memcpy(copy, s.data(), s.size());
+                p = copy;
+            }
+            uint32_t n = s.size();
+            memcpy(bytes, &p, sizeof p);
+            memcpy(bytes + 8, &n, sizeof n);
+            bytes[15] = (borrow ? BORROWED : OWNED) << 4;
         }
-        json(const val_type& t = OBJECT){
-            type = t;
-            if(t == OBJECT) val.object = new table();
-            if(t == ARRAY) val.array = new array_t();
-            if(t == STRING) val.str = new std::string();
+        void release(std::pmr::memory_resource *mr) noexcept {
+            if(kind() == OWNED) mr->deallocate(const_cast<char*>(ptr()), len(), 1);
         }
-        json(const std::string& rhs){
-            type = STRING;
-            val.str = new std::string(rhs);
+        inline std::string_view view() const noexcept {
+            return kind() == INLINE ? std::string_view(bytes, bytes[15] & 15) : std::string_view(ptr(), len());
         }
-        json(const char* rhs){
-            std::string s(rhs);
-            operator=(s);
+        inline operator std::string_view() const noexcept {
+            return view();
         }
-        json(int rhs){
-            operator=(rhs);
+        inline size_t size() const noexcept {
+            return view().size();
         }
-        json(int64_t rhs){
-            operator=(rhs);
+        inline bool operator==(std::string_view rhs) const noexcept {
+            return view() == rhs;
         }
-        json(double rhs){
-            operator=(rhs);
+        inline bool operator!=(std::string_view rhs) const noexcept {
+            return view() != rhs;
         }
-        void clean_type() noexcept {
-            if(type == OBJECT) delete val.object;
-            if(type == ARRAY){
-                delete val.array;
+        /* Whether the keys are equal. Equal bytes settle it (for interned keys, the same pointer),
+         * and an inline key can only be equal to another inline key. */
+        inline bool same(const key& rhs) const noexcept {
+            uint64_t a[2], b[2];
+            memcpy(a, bytes, sizeof a);
+            memcpy(b, rhs.bytes, sizeof b);
+            if(a[0] == b[0] && a[1] == b[1]) return true;
+            if(kind() == INLINE || rhs.kind() == INLINE) return false;
+            return view() == rhs.view();
+        }
+    };
+
+    /* A key prepared for lookups (see key_table::intern()): the key as members hold it, and its hash. */
+    struct interned_key {
+        key k;
+        uint64_t hash;
+        inline std::string_view view() const noexcept {
+            return k.view();
+        }
+    };
+
+    /* Keys stored once, for trees that repeat the same keys over and over.
+     * A key longer than key::inline_size is copied into the table the first time it's seen, and
+     * members parsed with the table (see json::parse()) borrow that copy instead of owning one.
+     * Shorter keys fit in the member anyway and aren't kept here. Looking up an interned_key
+     * in such a tree compares 16 bytes per candidate instead of strings.
+     * The table has to outlive every tree parsed with it. It isn't synchronized: to share one
+     * between threads, intern everything up front and freeze() it. A frozen table only hands out
+     * the keys it has, and members with other keys store them as usual.
+     */
+    class key_table {
+        struct entry {
+            const char *p;
+            uint64_t hash;
+            uint32_t len;
+        };
+        arena mem;
+        std::vector<entry> slots;       // open addressing, linear probing, p == nullptr if empty
+        size_t count = 0;
+        bool frozen_ = false;
+
+        void grow(){
+            std::vector<entry> old(2 * slots.size());
+            old.swap(slots);
+            for(const entry& e : old){
+                if(!e.p) continue;
+                size_t slot = e.hash & (slots.size() - 1);
+                while(slots[slot].p) slot = (slot + 1) & (slots.size() - 1);
+                slots[slot] = e;
             }
-            if(type == STRING) delete val.str;
-            type = INVALID_ITEM;
         }
-        ~json() noexcept {
-            clean_type();
+        public:
+        key_table() : mem(4096), slots(64) {}
+        key_table(const key_table&) = delete;
+        key_table& operator=(const key_table&) = delete;
+
+        /* The table's copy of `s`, which has a hash of `h`. A key that isn't there yet is added,
+         * unless the table is frozen or the key is short enough to be inline: then it's nullptr. */
+        const char *get(std::string_view s, uint64_t h){
+            if(s.size() <= key::inline_size || s.size() > UINT32_MAX) return nullptr;
+            size_t slot = h & (slots.size() - 1);
+            for(; slots[slot].p; slot = (slot + 1) & (slots.size() - 1)){
+                const entry& e = slots[slot];
+                if(e.hash == h && e.len == s.size() && !memcmp(e.p, s.data(), s.size())) return e.p;
+            }
+            if(frozen_) return nullptr;
+            char *copy = static_cast<char*>(mem.allocate(s.size(), 1));
+            memcpy(copy, s.data(), s.size());
+            slots[slot] = entry{copy, h, (uint32_t)s.size()};
+            if(2 * ++count > slots.size()) grow();
+            return copy;
         }
-        // }}}
-        // operators
-        // {{{
-        const json& operator=(const json rhs){
-            clean_type();
-            type = rhs.type;
-            if(type == OBJECT) val.object = new table(*rhs.val.object);
-            else if(type == ARRAY){
-                val.array = new array_t(*rhs.val.array);
+        const char *get(std::string_view s){
+            return get(s, key::hash(s));
+        }
+        /* Prepares `s` for lookups. Throws std::logic_error if it's new and the table is frozen. */
+        interned_key intern(std::string_view s){
+            interned_key ik;
+            ik.hash = key::hash(s);
+            const char *p = get(s, ik.hash);
+            if(!p && s.size() > key::inline_size) throw std::logic_error("hex::key_table: intern() on a frozen table");
+            ik.k.assign(p ? std::string_view(p, s.size()) : s, nullptr, true);
+            return ik;
+        }
+        /* From now on, nothing is added. */
+        inline void freeze() noexcept {
+            frozen_ = true;
+        }
+        inline bool frozen() const noexcept {
+            return frozen_;
+        }
+        /* Keys in the table. */
+        inline size_t size() const noexcept {
+            return count;
+        }
+    };
+
+    /* Array elements and object members live in one block allocated from a memory resource,
+     * right after this header. The node itself only holds a pointer to the first element and
+     * the count, so size() and indexing don't have to look at the block at all.
+     * A node without a block (a null pointer) is empty and belongs to the default resource.
+     * Blocks are reference counted: copying a node shares its block, and the first change made
+     * through a node whose block is shared gives it a copy of its own (copy-on-write).
+     */
+    struct block_header {
+        std::pmr::memory_resource *mr;
+        uint32_t cap;
+        uint32_t index_mask;    // objects only, see basic_object
+        uint32_t *index;
+        std::atomic<uint32_t> refs;
+    };
+    template<typename T>
+    struct block {
+        static_assert(alignof(T) <= alignof(block_header), "block elements are over-aligned");
+        static T *allocate(std::pmr::memory_resource *mr, uint32_t cap){
+            size_t size = sizeof(block_header) + (size_t)cap * sizeof(T);
+            HEX_JSON_STAT(stats->allocations++, stats->allocated_bytes += size);
+            void *p = mr->allocate(size, alignof(block_header));
+            return reinterpret_cast<T*>(new (p) block_header{mr, cap, 0, nullptr, {1}} + 1);
+        }
+        static inline block_header *header(T *items) noexcept {
+            return reinterpret_cast<block_header*>(items) - 1;
+        }
+        static void deallocate(T *items) noexcept {
+            block_header *h = header(items);
+            size_t size = sizeof(block_header) + (size_t)h->cap * sizeof(T);
+            std::pmr::memory_resource *mr = h->mr;
+            h->~block_header();
+            mr->deallocate(h, size, alignof(block_header));
+        }
+        static inline void share(T *items) noexcept {
+            if(items) header(items)->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        /* Whether the caller held the last reference, and should destroy the block. */
+        static inline bool unshare(T *items) noexcept {
+            return header(items)->refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+        static inline bool shared(T *items) noexcept {
+            return items && header(items)->refs.load(std::memory_order_acquire) != 1;
+        }
+    };
+
+    template<typename V>
+    struct basic_member {
+        key first;
+        V second;
+    };
+
+    /* A JSON array. This is a handle to a node (V), which holds the elements; copying the
+     * handle doesn't copy them. It's a template only so it can be declared before json is complete.
+     * Everything that can change the elements (including the non-const accessors) first makes
+     * sure the node doesn't share them, so references into an array are only good until the
+     * node is copied.
+     */
+    template<typename V>
+    class basic_array {
+        V *node;
+        inline V *&items() const noexcept {
+            return node->val.array;
+        }
+        inline uint32_t& used() const noexcept {
+            return node->len;
+        }
+        inline uint32_t cap() const noexcept {
+            return items() ? block<V>::header(items())->cap : 0;
+        }
+        /* Moves (or, if they're shared, copies) the elements to a new block of `n`, constructing
+         * `args` at the end of it first, so they may refer to elements of this array. */
+        template<typename... Args>
+        void grow(uint32_t n, Args&&... args){
+            std::pmr::memory_resource *mr = resource();
+            V *fresh = block<V>::allocate(mr, n), *old = items();
+            uint32_t i = 0;
+            bool copy = block<V>::shared(old), made = false;
+            try {
+                if constexpr(sizeof...(Args) > 0){
+                    new (fresh + used()) V(std::forward<Args>(args)...);
+                    made = true;
+                }
+                if(copy){
+                    for(; i < used(); i++) new (fresh + i) V(old[i], mr);
+                }
+            } catch(...){
+                if(made) fresh[used()].~V();
+                while(i) fresh[--i].~V();
+                block<V>::deallocate(fresh);
+                throw;
             }
-            else if(type == STRING) val.str = new std::string(*rhs.val.str);
-            else val = rhs.val;
-            return *this;
+            if(copy){
+                uint32_t count = used();
+                release();
+                used() = count;
+            } else {
+                for(; i < used(); i++){
+                    new (fresh + i) V(std::move(old[i]));
+                    old[i].~V();
+                }
+                if(old) block<V>::deallocate(old);
+            }
+            items() = fresh;
         }
-        const json& operator=(const val_type& t){
-            clean_type();
-            type = t;
-            if(t == OBJECT) val.object = new table();
-            if(t == ARRAY) val.array = new array_t();
-            if(t == STRING) val.str = new std::string();
-            return *this;
+        inline void detach(){
+            if(block<V>::shared(items())) grow(used());
         }
-        const json& operator=(const std::string& rhs){
-            clean_type();
-            type = STRING;
-            val.str = new std::string(rhs);
-            return *this;
+
+        public:
+        typedef V *iterator;
+        typedef const V *const_iterator;
+        explicit basic_array(V& node) noexcept : node(&node) {}
+        std::pmr::memory_resource *resource() const noexcept {
+            return items() ? block<V>::header(items())->mr : std::pmr::get_default_resource();
+        }
+        /* Drops the node's reference to the elements, destroying them if it was the last one.
+         * The node is left without a block. */
+        void release() noexcept {
+            V *old = items();
+            if(old && block<V>::unshare(old)){
+                for(uint32_t i = 0; i < used(); i++) old[i].~V();
+                block<V>::deallocate(old);
+            }
+            items() = nullptr;
+            used() = 0;
+        }
+        inline size_t size() const noexcept {
+            return used();
+        }
+        inline bool empty() const noexcept {
+            return used() == 0;
+        }
+        inline iterator begin(){
+            detach();
+            return items();
+        }
+        inline iterator end(){
+            detach();
+            return items() + used();
+        }
+        inline const_iterator begin() const noexcept {
+            return items();
+        }
+        inline const_iterator end() const noexcept {
+            return items() + used();
+        }
+        inline V& operator[](size_t i){
+            detach();
+            return items()[i];
+        }
+        inline const V& operator[](size_t i) const noexcept {
+            return items()[i];
+        }
+        inline V& front(){
+            detach();
+            return items()[0];
+        }
+        inline V& back(){
+            detach();
+            return items()[used() - 1];
+        }
+        inline const V& back() const noexcept {
+            return items()[used() - 1];
+        }
+        void reserve(uint32_t n){
+            if(n > cap()) grow(n);
+            else detach();
+        }
+        template<typename... Args>
+        V& emplace_back(Args&&... args){
+            if(used() == cap() || block<V>::shared(items())){
+                if(used() == UINT32_MAX) throw std::length_error("hex::json: array too long");
+                uint32_t n = used() < cap() ? cap() : used() ? (used() > UINT32_MAX / 2 ? UINT32_MAX : 2 * used()) : 4;
+                grow(n, std::forward<Args>(args)...);
+            } else {
+                new (items() + used()) V(std::forward<Args>(args)...);
+            }
+            return items()[used()++];
+        }
+        /* Copies are allocated from the array's resource, and so are values moved in from
+         * another resource. The copy is made first: if it shares the elements, adding it makes
+         * the array copy them. */
+        void push_back(const V& v){
+            emplace_back(node->copy_for(v, resource()));
+        }
+        void push_back(V&& v){
+            if(v.resource() == resource()) emplace_back(std::move(v));
+            else emplace_back(v, resource());
+        }
+        void pop_back(){
+            detach();
+            items()[--used()].~V();
+        }
+        void clear(){
+            if(block<V>::shared(items())){
+                std::pmr::memory_resource *mr = resource();
+                release();
+                items() = V::template empty_block<V>(mr);
+                return;
+            }
+            for(uint32_t i = 0; i < used(); i++) items()[i].~V();
+            used() = 0;
+        }
+        bool operator==(const basic_array& rhs) const noexcept {
+            return used() == rhs.used() && (items() == rhs.items() || std::equal(begin(), end(), rhs.begin()));
+        }
+        inline bool operator!=(const basic_array& rhs) const noexcept {
+            return !operator==(rhs);
+        }
+    };
+
+    /* A JSON object: members are kept contiguous and in insertion order.
+     * Small objects are searched linearly; once there are more than `linear_limit` members an
+     * open addressing hash index (linear probing, positions + 1, 0 meaning empty) is kept in the
+     * block header. Like basic_array, this is a handle to the node holding the members, and
+     * shared members are copied before they can be changed.
+     */
+    template<typename V>
+    class basic_object {
+        public:
+        typedef basic_member<V> member;
+        typedef member *iterator;
+        typedef const member *const_iterator;
+        static constexpr uint32_t linear_limit = 16;
+
+        private:
+        V *node;
+        inline member *&items() const noexcept {
+            return node->val.members;
+        }
+        inline uint32_t& used() const noexcept {
+            return node->len;
+        }
+        /* Only valid if there are items. */
+        inline block_header *head() const noexcept {
+            return block<member>::header(items());
+        }
+
+        static inline uint64_t hash(std::string_view s) noexcept {
+            return key::hash(s);
+        }
+        /* Moves a member to uninitialized memory, leaving `src` to be forgotten. */
+        static void relocate(member *dst, member *src) noexcept {
+            new (dst) member{src->first, std::move(src->second)};
+            src->second.~V();
+        }
+        void index_insert(uint32_t pos) noexcept {
+            block_header *h = head();
+            uint32_t slot = hash(items()[pos].first.view()) & h->index_mask;
+            while(h->index[slot]) slot = (slot + 1) & h->index_mask;
+            h->index[slot] = pos + 1;
+        }
+        /* (Re)builds the index, big enough to stay at most half full until `n` members. */
+        void rehash(uint32_t n){
+            drop_index();
+            block_header *h = head();
+            uint32_t size = 32;
+            while(size < 2 * n) size *= 2;
+            h->index = static_cast<uint32_t*>(h->mr->allocate(size * sizeof(uint32_t), alignof(uint32_t)));
+            memset(h->index, 0, size * sizeof(uint32_t));
+            h->index_mask = size - 1;
+            for(uint32_t i = 0; i < used(); i++) index_insert(i);
+        }
+        void drop_index() noexcept {
+            if(!items()) return;
+            block_header *h = head();
+            if(h->index) h->mr->deallocate(h->index, (h->index_mask + 1) * sizeof(uint32_t), alignof(uint32_t));
+            h->index = nullptr;
+            h->index_mask = 0;
+        }
+        /* Position of `k`, or used if it isn't there. */
+        uint32_t position(std::string_view k) const noexcept {
+            member *m = items();
+            uint32_t n = used();
+            if(!m || !head()->index){
+                for(uint32_t i = 0; i < n; i++){
+                    if(m[i].first.view() == k) return i;
+                }
+                return n;
+            }
+            const block_header *h = head();
+            for(uint32_t slot = hash(k) & h->index_mask; h->index[slot]; slot = (slot + 1) & h->index_mask){
+                if(m[h->index[slot] - 1].first.view() == k) return h->index[slot] - 1;
+            }
+            return n;
+        }
+        /* The same, with the hash already known and keys compared by their bytes first. */
+        uint32_t position(const interned_key& k) const noexcept {
+            member *m = items();
+            uint32_t n = used();
+            if(!m || !head()->index){
+                for(uint32_t i = 0; i < n; i++){
+                    if(m[i].first.same(k.k)) return i;
+                }
+                return n;
+            }
+            const block_header *h = head();
+            for(uint32_t slot = k.hash & h->index_mask; h->index[slot]; slot = (slot + 1) & h->index_mask){
+                if(m[h->index[slot] - 1].first.same(k.k)) return h->index[slot] - 1;
+            }
+            return n;
+        }
+        /* Gives the node a block of its own, of at least `n` members. */
+        void clone(uint32_t n){
+            std::pmr::memory_resource *mr = resource();
+            member *old = items(), *fresh = block<member>::allocate(mr, std::max(n, used()));
+            uint32_t i = 0;
+            try {
+                for(; i < used(); i++){
+                    new (&fresh[i].first) key();
+                    fresh[i].first.assign(old[i].first.view(), mr, false);
+                    try {
+                        new (&fresh[i].second) V(old[i].second, mr);
+                    } catch(...){
+                        fresh[i].first.release(mr);
+                        throw;
+                    }
+                }
+            } catch(...){
+                while(i){
+                    i--;
+                    fresh[i].first.release(mr);
+                    fresh[i].second.~V();
+                }
+                block<member>::deallocate(fresh);
+                throw;
+            }
+            uint32_t count = used();
+            release();
+            items() = fresh;
+            used() = count;
+            if(count > linear_limit) rehash(count);
+        }
+        inline void detach(){
+            if(block<member>::shared(items())) clone(used());
+        }
+        template<typename... Args>
+        std::pair<iterator, bool> emplace_new(std::string_view k, bool borrow, Args&&... args){
+            detach();
+            uint32_t pos = position(k);
+            if(pos != used()) return {items() + pos, false};
+            if(used() == cap()){
+                if(used() == UINT32_MAX) throw std::length_error("hex::json: object too large");
+                reserve(used() ? (used() > UINT32_MAX / 2 ? UINT32_MAX : 2 * used()) : 4);
+            }
+            member *m = items() + used();
+            new (&m->first) key();
+            m->first.assign(k, resource(), borrow);
+            new (&m->second) V(std::forward<Args>(args)...);
+            uint32_t n = ++used();
+            block_header *h = head();
+            if(h->index){
+                if(2 * n > h->index_mask + 1) rehash(n);
+                else index_insert(n - 1);
+            } else if(n > linear_limit){
+                rehash(n);
+            }
+            return {m, true};
+        }
+
+        public:
+        explicit basic_object(V& node) noexcept : node(&node) {}
+        std::pmr::memory_resource *resource() const noexcept {
+            return items() ? head()->mr : std::pmr::get_default_resource();
+        }
+        /* Drops the node's reference to the members, destroying them if it was the last one.
+         * The node is left without a block. */
+        void release() noexcept {
+            member *old = items();
+            if(old && block<member>::unshare(old)){
+                block_header *h = block<member>::header(old);
+                for(uint32_t i = 0; i < used(); i++){
+                    old[i].first.release(h->mr);
+                    old[i].second.~V();
+                }
+                if(h->index) h->mr->deallocate(h->index, (h->index_mask + 1) * sizeof(uint32_t), alignof(uint32_t));
+                block<member>::deallocate(old);
+            }
+            items() = nullptr;
+            used() = 0;
+        }
+        inline uint32_t cap() const noexcept {
+            return items() ? head()->cap : 0;
+        }
+        inline size_t size() const noexcept {
+            return used();
+        }
+        inline bool empty() const noexcept {
+            return used() == 0;
+        }
+        inline iterator begin(){
+            detach();
+            return items();
+        }
+        inline iterator end(){
+            detach();
+            return items() + used();
+        }
+        inline const_iterator begin() const noexcept {
+            return items();
+        }
+        inline const_iterator end() const noexcept {
+            return items() + used();
+        }
+        void reserve(uint32_t n){
+            if(block<member>::shared(items())) return clone(n);
+            if(n <= cap()) return;
+            member *fresh = block<member>::allocate(resource(), n);
+            member *old = items();
+            if(old){
+                for(uint32_t i = 0; i < used(); i++) relocate(fresh + i, old + i);
+                // The index holds positions, so it stays valid.
+                block<member>::header(fresh)->index = head()->index;
+                block<member>::header(fresh)->index_mask = head()->index_mask;
+                block<member>::deallocate(old);
+            }
+            items() = fresh;
+        }
+        void clear(){
+            if(block<member>::shared(items())){
+                std::pmr::memory_resource *mr = resource();
+                release();
+                items() = V::template empty_block<member>(mr);
+                return;
+            }
+            std::pmr::memory_resource *mr = resource();
+            for(uint32_t i = 0; i < used(); i++){
+                items()[i].first.release(mr);
+                items()[i].second.~V();
+            }
+            used() = 0;
+            drop_index();
+        }
+        iterator find(std::string_view k){
+            detach();
+            return items() + position(k);
+        }
+        const_iterator find(std::string_view k) const noexcept {
+            return items() + position(k);
+        }
+        iterator find(const interned_key& k){
+            detach();
+            return items() + position(k);
+        }
+        const_iterator find(const interned_key& k) const noexcept {
+            return items() + position(k);
+        }
+        size_t count(std::string_view k) const noexcept {
+            return position(k) != used();
+        }
+        /* Adds `k` with a value constructed from `args`, unless it's already there.
+         * Either way, returns the member and whether it was added. */
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(std::string_view k, Args&&... args){
+            return emplace_new(k, false, std::forward<Args>(args)...);
+        }
+        /* Same, but a long key isn't copied: its bytes have to outlive the object. */
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace_view(std::string_view k, Args&&... args){
+            return emplace_new(k, true, std::forward<Args>(args)...);
+        }
+        size_t erase(std::string_view k){
+            if(position(k) == used()) return 0;
+            detach();
+            uint32_t pos = position(k);
+            member *m = items();
+            m[pos].first.release(resource());
+            m[pos].second.~V();
+            for(uint32_t i = pos + 1; i < used(); i++) relocate(m + i - 1, m + i);
+            uint32_t n = --used();
+            if(head()->index){
+                if(n > linear_limit) rehash(n);
+                else drop_index();
+            }
+            return 1;
+        }
+        /* Member order doesn't matter for equality. */
+        bool operator==(const basic_object& rhs) const noexcept {
+            if(used() != rhs.used()) return false;
+            if(items() == rhs.items()) return true;
+            for(const member& m : *this){
+                const_iterator it = rhs.find(m.first.view());
+                if(it == rhs.end() || it->second != m.second) return false;
+            }
+            return true;
+        }
+        inline bool operator!=(const basic_object& rhs) const noexcept {
+            return !operator==(rhs);
+        }
+    };
+
+    /* Base for handlers passed to json::parse_sax(). Handlers are template parameters, so calls are
+     * resolved at compile time: derive from this and hide only the events you care about.
+     * Returning false from any of them stops parsing.
+     */
+    struct sax_handler {
+        bool on_start_object(){ return true; }
+        bool on_key(std::string_view){ return true; }
+        bool on_end_object(){ return true; }
+        bool on_start_array(){ return true; }
+        bool on_end_array(){ return true; }
+        bool on_string(std::string_view){ return true; }
+        bool on_int64(int64_t){ return true; }
+        bool on_double(double){ return true; }
+        bool on_bool(bool){ return true; }
+        bool on_null(){ return true; }
+    };
+
+    /* Where serialized text goes when it isn't kept in memory.
+     * The serializer buffers its output and hands it to write() in large pieces.
+     */
+    class sink {
+        public:
+        virtual void write(const char *data, size_t size) = 0;
+        /* Writes several pieces, in order. */
+        virtual void writev(const std::string_view *pieces, size_t n){
+            for(size_t i = 0; i < n; i++) write(pieces[i].data(), pieces[i].size());
+        }
+        virtual ~sink() = default;
+    };
+#ifdef HEX_JSON_POSIX
+    /* Writes to a file descriptor. Throws std::system_error if write(2) fails. */
+    class fd_sink : public sink {
+        int fd;
+        public:
+        explicit fd_sink(int fd) : fd(fd) {}
+        void write(const char *data, size_t size) override {
+            while(size){
+                ssize_t n = ::write(fd, data, size);
+                if(n < 0){
+                    if(errno == EINTR) continue;
+                    throw std::system_error(errno, std::generic_category(), "hex::fd_sink");
+                }
+                data += n;
+                size -= n;
+            }
+        }
+        /* Gathers the pieces with writev(2), IOV_MAX at a time. */
+        void writev(const std::string_view *pieces, size_t n) override {
+            std::vector<iovec> iov;
+            for(size_t i = 0; i < n; i++){
+                if(pieces[i].size()) iov.push_back({const_cast<char*>(pieces[i].data()), pieces[i].size()});
+            }
+            for(size_t i = 0; i < iov.size();){
+                ssize_t done = ::writev(fd, &iov[i], std::min<size_t>(iov.size() - i, IOV_MAX));
+                if(done < 0){
+                    if(errno == EINTR) continue;
+                    throw std::system_error(errno, std::generic_category(), "hex::fd_sink");
+                }
+                // Skip what was written, which may end in the middle of a piece.
+                for(; i < iov.size() && (size_t)done >= iov[i].iov_len; i++) done -= iov[i].iov_len;
+                if(done){
+                    iov[i].iov_base = static_cast<char*>(iov[i].iov_base) + done;
+                    iov[i].iov_len -= done;
+                }
+            }
+        }
+    };
+#endif
+    /* Writes to a stdio stream. Throws std::system_error if fwrite() fails. */
+    class file_sink : public sink {
+        FILE *f;
+        public:
+        explicit file_sink(FILE *f) : f(f) {}
+        void write(const char *data, size_t size) override {
+            if(fwrite(data, 1, size, f) != size) throw std::system_error(errno, std::generic_category(), "hex::file_sink");
+        }
+    };
+    /* Calls a function with every piece of output. */
+    class callback_sink : public sink {
+        std::function<void(const char*, size_t)> f;
+        public:
+        explicit callback_sink(std::function<void(const char*, size_t)> f) : f(std::move(f)) {}
+        void write(const char *data, size_t size) override {
+            f(data, size);
+        }
+    };
+    class serializer;
+
+    class json;
+    /* Containers take a std::pmr::memory_resource, so a tree can either live on the heap
+     * (the default resource) or entirely inside an arena (see hex::document). */
+    typedef std::pmr::string string_t;
+    typedef basic_object<json> object;
+    typedef object table;
+    typedef basic_array<json> array_t;
+    union value {
+        double decimal;
+        int64_t integer;
+        basic_member<json> *members;
+        json *array;
+        const char *chars;
+        bool boolean;
+        const char *invalid_end;
+    };
+    /* A node is 16 bytes, and only strings longer than 14 bytes, arrays and objects point elsewhere:
+     *   OBJECT, ARRAY: the first member or element in val, their count in len (see block).
+     *   STRING: inline, the bytes from the start of the node up to `flags`; otherwise val.chars and
+     *           len. Owned bytes are preceded by the resource they came from and a reference count.
+     *   INVALID_ITEM: after a failed parse, where it failed in val.invalid_end and why in len.
+     * Copying a node into the resource its payload is in shares the payload (see block), so
+     * copies of big values are cheap, and only what's changed afterwards is copied.
+     */
+    class json {
+        public:
+        value val;
+        uint32_t len;
+        char spare[2];          // the end of inline strings
+        /* BORROWED: the STRING is `len` bytes at val.chars, owned by someone else.
+         * INLINE: the STRING is in the node, its length is in the high nibble. */
+        uint8_t flags = 0;
+        val_type type;
+        static constexpr uint8_t BORROWED = 1, INLINE = 2;
+        static constexpr size_t inline_size = 14;
+        /* How deeply parsers let arrays and objects nest, unless they're told otherwise. Deeper input
+         * fails with TOO_DEEP instead of exhausting the stack of whoever walks the tree. */
+        static inline size_t default_max_depth = 1024;
+        // payload management
+        // {{{
+        /* What's in front of the bytes of an owned long string. Strings never change, so sharing
+         * them only needs the count. */
+        struct chars_header {
+            std::pmr::memory_resource *mr;
+            std::atomic<uint32_t> refs;
+        };
+        static char *allocate_chars(std::pmr::memory_resource *mr, size_t n){
+            HEX_JSON_STAT(stats->allocations++, stats->allocated_bytes += sizeof(chars_header) + n);
+            void *p = mr->allocate(sizeof(chars_header) + n, alignof(chars_header));
+            return reinterpret_cast<char*>(new (p) chars_header{mr, {1}} + 1);
+        }
+        inline chars_header *chars_head() const noexcept {
+            return reinterpret_cast<chars_header*>(const_cast<char*>(val.chars)) - 1;
+        }
+        inline std::pmr::memory_resource *chars_resource() const noexcept {
+            return chars_head()->mr;
+        }
+        inline bool owns_chars() const noexcept {
+            return type == STRING && !(flags & (BORROWED | INLINE));
+        }
+        /* Empty containers on the heap don't need a block; elsewhere it remembers the resource. */
+        template<typename T>
+        static T *empty_block(std::pmr::memory_resource *mr){
+            return mr == std::pmr::get_default_resource() ? nullptr : block<T>::allocate(mr, 0);
+        }
+        /* The resource this node's payload came from (the default resource if it has none). */
+        std::pmr::memory_resource *resource() const noexcept {
+            if(type == OBJECT) return as_obj().resource();
+            if(type == ARRAY) return as_arr().resource();
+            if(owns_chars()) return chars_resource();
+            return std::pmr::get_default_resource();
+        }
+        /* Where a new payload for this node comes from: the resource of the one it has, or if it has
+         * none (a number, say), the arena the node is in. Nodes in an arena are never destroyed, so
+         * a payload from anywhere else would leak. */
+        std::pmr::memory_resource *home() const noexcept {
+            if(type == OBJECT || type == ARRAY || owns_chars()) return resource();
+            arena *a = arena::owner(this);
+            return a ? a : std::pmr::get_default_resource();
+        }
+        /* Whether a copy of this node allocates. */
+        inline bool allocates() const noexcept {
+            return type == OBJECT || type == ARRAY || (type == STRING && !(flags & INLINE));
+        }
+        void set_type(const val_type& t, std::pmr::memory_resource *mr){
+            clean_type();
+            if(t == OBJECT){
+                val.members = empty_block<object::member>(mr);
+                len = 0;
+            }
+            if(t == ARRAY){
+                val.array = empty_block<json>(mr);
+                len = 0;
+            }
+            if(t == STRING) flags = INLINE;
+            type = t;
+        }
+        /* Makes this a STRING holding a copy of `s`, which may be this node's own string. */
+        void set_string(std::string_view s, std::pmr::memory_resource *mr){
+            char small[inline_size];
+            char *p = small;
+            if(s.size() > UINT32_MAX) throw std::length_error("hex::json: string too long");
+            if(s.size() > inline_size) p = allocate_chars(mr, s.size());
+            memcpy(p, s.data(), s.size());
+            clean_type();
+            if(p == small){
+                memcpy(reinterpret_cast<char*>(this), small, s.size());
+                flags = INLINE | s.size() << 4;
+            } else {
+                val.chars = p;
+                len = s.size();
+            }
+            type = STRING;
+        }
+        /* Makes this a copy of rhs that shares its payload. */
+        void share(const json& rhs) noexcept {
+            val = rhs.val;
+            len = rhs.len;
+            flags = rhs.flags;
+            type = rhs.type;
+            if(type == OBJECT) block<object::member>::share(val.members);
+            else if(type == ARRAY) block<json>::share(val.array);
+            else chars_head()->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        /* Whether the block holding this array's elements or this object's members is shared. */
+        inline bool shares_block() const noexcept {
+            return type == ARRAY ? block<json>::shared(val.array) : block<object::member>::shared(val.members);
+        }
+        /* Whether this node is somewhere in the payload of `j`. Only blocks with a single owner
+         * are looked at, since nodes that can be changed are never in shared ones. */
+        bool inside(const json& j) const noexcept {
+            if(!(j.type == ARRAY || j.type == OBJECT) || !j.len || j.shares_block()) return false;
+            uintptr_t self = reinterpret_cast<uintptr_t>(this), first = reinterpret_cast<uintptr_t>(j.val.array);
+            if(j.type == ARRAY){
+                if(self >= first && self < first + j.len * sizeof(json)) return true;
+                for(uint32_t i = 0; i < j.len; i++){
+                    if(inside(j.val.array[i])) return true;
+                }
+                return false;
+            }
+            if(self >= first && self < first + j.len * sizeof(object::member)) return true;
+            for(uint32_t i = 0; i < j.len; i++){
+                if(inside(j.val.members[i].second)) return true;
+            }
+            return false;
+        }
+        /* With `unshared`, blocks that have a single owner are copied rather than shared. */
+        void copy_from(const json& rhs, std::pmr::memory_resource *mr, bool unshared = false){
+            type = INVALID_ITEM;
+            flags = 0;
+            bool container = rhs.type == OBJECT || rhs.type == ARRAY;
+            // Payloads can only be shared within a resource, so that nodes in an arena stay there.
+            if((container || rhs.owns_chars()) && rhs.resource() == mr && !(unshared && container && !rhs.shares_block())){
+                share(rhs);
+            }
+            else if(container){
+                set_type(rhs.type, mr);
+                try {
+                    if(rhs.type == OBJECT){
+                        object o = as_obj();
+                        o.reserve(rhs.len);
+                        for(const auto& m : rhs.as_obj()){
+                            o.try_emplace(m.first.view(), INVALID_ITEM).first->second.copy_from(m.second, mr, unshared);
+                        }
+                    } else {
+                        array_t a = as_arr();
+                        a.reserve(rhs.len);
+                        for(const json& e : rhs.as_arr()) a.emplace_back(INVALID_ITEM).copy_from(e, mr, unshared);
+                    }
+                } catch(...){
+                    clean_type();
+                    throw;
+                }
+            }
+            // Copies always own their bytes, even if rhs borrows them.
+            else if(rhs.type == STRING) set_string(rhs.as_str(), mr);
+            else {
+                val = rhs.val;
+                len = rhs.len;
+                type = rhs.type;
+            }
+        }
+        /* A copy of rhs, allocated from `mr`, to keep in this node or under it.
+         * If this node is inside rhs (j[0] = j), the blocks it's in are copied instead of shared,
+         * or it would end up containing itself. */
+        json copy_for(const json& rhs, std::pmr::memory_resource *mr) const {
+            json copy(INVALID_ITEM);
+            copy.copy_from(rhs, mr, inside(rhs));
+            return copy;
+        }
+        /* Makes this a STRING that points at `s` instead of owning a copy.
+         * The bytes have to outlive the node. Short strings are inline anyway, and strings too
+         * long to borrow are copied into `mr`.
+         */
+        void set_view(std::string_view s, std::pmr::memory_resource *mr){
+            if(s.size() <= inline_size || s.size() > UINT32_MAX) return set_string(s, mr);
+            clean_type();
+            val.chars = s.data();
+            len = s.size();
+            flags = BORROWED;
+            type = STRING;
+        }
+        /* Takes over the payload of rhs, which becomes INVALID_ITEM. This node has to be empty. */
+        void steal(json& rhs) noexcept {
+            val = rhs.val;
+            len = rhs.len;
+            memcpy(spare, rhs.spare, sizeof spare);
+            flags = rhs.flags;
+            type = rhs.type;
+            rhs.type = INVALID_ITEM;
+            rhs.flags = 0;
+            rhs.len = 0;
+        }
+        // }}}
+        // constructors and destructors
+        // {{{
+        json(const json& rhs){
+            copy_from(rhs, std::pmr::get_default_resource());
+        }
+        /* Copy whose payloads are in `mr`: ones already there are shared, the others copied. */
+        json(const json& rhs, std::pmr::memory_resource *mr){
+            copy_from(rhs, mr);
+        }
+        json(json&& rhs) noexcept {
+            /* Move constructor, more like pilfer constructor. */
+            steal(rhs);
+        }
+        json(const val_type& t = OBJECT) : json(t, std::pmr::get_default_resource()) {}
+        json(const val_type& t, std::pmr::memory_resource *mr){
+            type = INVALID_ITEM;
+            set_type(t, mr);
+        }
+        json(const std::string& rhs){
+            type = INVALID_ITEM;
+            set_string(rhs, std::pmr::get_default_resource());
+        }
+        json(const char* rhs){
+            type = INVALID_ITEM;
+            set_string(rhs, std::pmr::get_default_resource());
+        }
+        json(int rhs){
+            type = INVALID_ITEM;
+            operator=(rhs);
+        }
+        json(int64_t rhs){
+            type = INVALID_ITEM;
+            operator=(rhs);
+        }
+        json(double rhs){
+            type = INVALID_ITEM;
+            operator=(rhs);
+        }
+        void clean_type() noexcept {
+            if(type == OBJECT) as_obj().release();
+            if(type == ARRAY) as_arr().release();
+            if(owns_chars()){
+                chars_header *h = chars_head();
+                if(h->refs.fetch_sub(1, std::memory_order_acq_rel) == 1){
+                    std::pmr::memory_resource *mr = h->mr;
+                    h->~chars_header();
+                    mr->deallocate(h, sizeof(chars_header) + len, alignof(chars_header));
+                }
+            }
+            type = INVALID_ITEM;
+            flags = 0;
+            len = 0;
+        }
+        ~json() noexcept {
+            clean_type();
+        }
+        // }}}
+        // operators
+        // {{{
+        const json& operator=(const json& rhs){
+            if(this != &rhs){
+                // rhs may be inside this node's payload, so it's copied first.
+                json copy = copy_for(rhs, rhs.allocates() ? home() : resource());
+                clean_type();
+                steal(copy);
+            }
+            return *this;
+        }
+        /* Takes over rhs's payload if it's from where this node's would come from, or copies it. */
+        const json& operator=(json&& rhs){
+            if(this == &rhs) return *this;
+            bool owned = rhs.type == OBJECT || rhs.type == ARRAY || rhs.owns_chars();
+            if(owned && rhs.resource() != home()) return operator=(static_cast<const json&>(rhs));
+            json moved(std::move(rhs));
+            clean_type();
+            steal(moved);
+            return *this;
+        }
+        const json& operator=(const val_type& t){
+            set_type(t, t == OBJECT || t == ARRAY ? home() : resource());
+            return *this;
+        }
+        const json& operator=(const std::string& rhs){
+            return operator=(std::string_view(rhs));
+        }
+        const json& operator=(std::string_view rhs){
+            set_string(rhs, rhs.size() > inline_size ? home() : resource());
+            return *this;
+        }
+        const json& operator=(int rhs){
+            clean_type();
+            type = INTEGER;
+            val.integer = rhs;
+            return *this;
+        }
+        const json& operator=(int64_t rhs){
+            clean_type();
+            type = INTEGER;
+            val.integer = rhs;
+            return *this;
+        }
+        const json& operator=(double rhs){
+            clean_type();
+            type = DECIMAL;
+            val.decimal = rhs;
+            return *this;
+        }
+        const json& operator=(const char* rhs){
+            std::string s(rhs);
+            operator=(s);
+            return *this;
+        }
+        const json& operator=(const array_t& rhs){
+            std::pmr::memory_resource *mr = home();
+            // rhs may be this array, so the copy is made first.
+            json fresh(ARRAY, mr);
+            array_t a = fresh.as_arr();
+            a.reserve(rhs.size());
+            for(const json& e : rhs) a.emplace_back(copy_for(e, mr));
+            clean_type();
+            steal(fresh);
+            return *this;
+        }
+        bool operator==(const json& rhs) const noexcept {
+            return type == rhs.type &&
+                (type == OBJECT ? as_obj() == rhs.as_obj() :
+                 type == ARRAY ? as_arr() == rhs.as_arr() :
+                 type == STRING ? as_str() == rhs.as_str() :
+                 type == BOOLEAN ? val.boolean == rhs.val.boolean :
+                 type == UNDEFINED ? true :
+                 /* all other types are 64 bit */ val.integer == rhs.val.integer);
+        }
+        inline bool operator!=(const json& rhs) const noexcept {
+            return !operator==(rhs);
+        }
+        json& operator[](std::string_view key){
+            object o = as_obj();
+            auto it = o.find(key);
+            if(it == o.end()){
+                // New members are allocated from the same resource as the object.
+                it = o.try_emplace(key, OBJECT, o.resource()).first;
+            }
+            return it->second;
+        }
+        json& operator[](size_t idx){
+            return as_arr()[idx];
+        }
+        /* Lookups on a tree you can't change, like parser's: a missing key gives an INVALID_ITEM. */
+        const json& operator[](std::string_view key) const {
+            static const json missing(INVALID_ITEM);
+            const object o = as_obj();
+            auto it = o.find(key);
+            return it == o.end() ? missing : it->second;
+        }
+        const json& operator[](size_t idx) const {
+            return val.array[idx];
+        }
+        /* Lookups with a key prepared by key_table::intern(), for keys used over and over. */
+        json& operator[](const interned_key& key){
+            object o = as_obj();
+            auto it = o.find(key);
+            if(it == o.end()) it = o.try_emplace(key.view(), OBJECT, o.resource()).first;
+            return it->second;
+        }
+        const json& operator[](const interned_key& key) const {
+            static const json missing(INVALID_ITEM);
+            const object o = as_obj();
+            auto it = o.find(key);
+            return it == o.end() ? missing : it->second;
+        }
+        // }}}
+        // convenience functions
+        // {{{
+        inline bool& as_bool() noexcept {
+            return val.boolean;
+        }
+        inline int64_t& as_int() noexcept {
+            return val.integer;
+        }
+        inline std::string_view as_str() const noexcept {
+            return flags & INLINE ? std::string_view(reinterpret_cast<const char*>(this), flags >> 4)
+                                  : std::string_view(val.chars, len);
+        }
+        inline double& as_double(){
+            return val.decimal;
+        }
+        void push_back(const json& j){
+            as_arr().push_back(j);
+        }
+        void push_back(json&& j){
+            as_arr().push_back(std::move(j));
+        }
+        void pop_back(){
+            as_arr().pop_back();
+        }
+        inline bool invalid() const noexcept {
+            return type == INVALID_ITEM;
+        }
+        /* Why parse() failed, for an invalid() result (val.invalid_end is where). */
+        inline parse_error error_code() const noexcept {
+            return type == INVALID_ITEM ? len : PARSE_OK;
+        }
+        inline const size_t size() const noexcept {
+            return type == OBJECT || type == ARRAY ? len : /* type == STRING */ as_str().size();
+        }
+        inline json& back(){
+            return as_arr().back();
+        }
+        /* Arrays and objects are used through handles to the node. */
+        inline array_t as_arr() noexcept {
+            return array_t(*this);
+        }
+        inline const array_t as_arr() const noexcept {
+            return array_t(const_cast<json&>(*this));
+        }
+        inline object as_obj() noexcept {
+            return object(*this);
+        }
+        inline const object as_obj() const noexcept {
+            return object(const_cast<json&>(*this));
+        }
+        // }}}
+        // stringify functions
+        // {{{
+        /* Serializes to compact JSON text. */
+        std::string dump() const;
+        void dump(sink& out) const;
+        /* The same text, but large arrays and objects are split into chunks serialized on `pool`. */
+        std::string dump(thread_pool& pool) const;
+        void dump(sink& out, thread_pool& pool) const;
+        // }}}
+        /* Static functions */
+        // {{{
+        static json make_obj(const std::initializer_list< std::pair<std::string, json> >& t){
+            json ret(OBJECT);
+            object o = ret.as_obj();
+            o.reserve(t.size());
+            // Copying the values only shares their payloads. Later duplicates win, as in parse().
+            for(const auto& m : t){
+                auto member = o.try_emplace(m.first, m.second);
+                if(!member.second) member.first->second = m.second;
+            }
+            return ret;
+        }
+        static json make_arr(const std::initializer_list<json>& t){
+            json ret(ARRAY);
+            array_t a = ret.as_arr();
+            a.reserve(t.size());
+            for(const json& e : t) a.push_back(e);
+            return ret;
+        }
+        static inline bool is_space(char c){
+            // Whitespace in JSON is any of 0x20 (space), 0x09 (horizontal tab), 0x0a (\n), 0x0d (\r).
+            return (c == 0x20 || c == 0x09 || c == 0x0a || c == 0x0d);
+        }
+
+        /* Characters that can appear inside a string as they are. */
+        static inline bool is_plain(char c){
+            return (unsigned char)c >= 0x20 && c != '"' && c != '\\';
+        }
+        /* Returns the first character in [str, end) that isn't plain (or end if there isn't one).
+         * Only used inside strings whose closing quote is known, so it's looking for a backslash
+         * or a control character. `ascii` is set to whether everything before it is ASCII, which
+         * costs one more instruction per block and saves most strings a trip through the UTF-8
+         * validator.
+         */
+        static const char *find_special(const char *str, const char *end, bool& ascii){
+            unsigned high = 0;
+#ifdef HEX_JSON_X86
+            const __m128i backslash = _mm_set1_epi8('\\'), control = _mm_set1_epi8(0x1f);
+            __m128i seen = _mm_setzero_si128();
+            for(; end - str >= 16; str += 16){
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str));
+                // v <= 0x1f (unsigned) exactly when max(v, 0x1f) == 0x1f.
+                __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, backslash),
+                                               _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+                int mask = _mm_movemask_epi8(special);
+                if(mask){
+                    // Only the bytes before the special one count.
+                    high = _mm_movemask_epi8(v) & ((mask & -mask) - 1);
+                    str += __builtin_ctz(mask);
+                    break;
+                }
+                seen = _mm_or_si128(seen, v);
+            }
+            high |= _mm_movemask_epi8(seen);
+#endif
+            for(; str != end && is_plain(*str); str++) high |= (unsigned char)*str & 0x80;
+            ascii = !high;
+            return str;
+        }
+        static const char *find_special(const char *str, const char *end){
+            bool ascii;
+            return find_special(str, end, ascii);
+        }
+
+        /* Returns the first byte in [str, end) that doesn't belong to well-formed UTF-8 (RFC 3629: no
+         * overlong forms, no surrogates, nothing above U+10FFFF), or end. A sequence cut off by `end`
+         * is malformed too.
+         */
+        static const char *find_invalid_utf8(const char *str, const char *end){
+#ifdef HEX_JSON_X86
+            static const bool ssse3 = __builtin_cpu_supports("ssse3");
+            // The vector check only says yes or no; the scalar one finds the byte.
+            if(ssse3 && utf8_valid_ssse3(str, end)) return end;
+#endif
+            const unsigned char *p = reinterpret_cast<const unsigned char*>(str),
+                                *e = reinterpret_cast<const unsigned char*>(end);
+            while(p != e){
+                uint64_t word;
+                if(e - p >= 8 && (memcpy(&word, p, 8), !(word & 0x8080808080808080))){
+                    p += 8;
+                    continue;
+                }
+                unsigned char c = *p;
+                size_t n;
+                // The second byte has a narrower range after a few leads.
+                unsigned char lo = 0x80, hi = 0xbf;
+                if(c < 0x80) n = 1;
+                else if(c < 0xc2) break;
+                else if(c < 0xe0) n = 2;
+                else if(c < 0xf0){
+                    n = 3;
+                    if(c == 0xe0) lo = 0xa0;            // overlong
+                    else if(c == 0xed) hi = 0x9f;       // surrogates
+                } else if(c < 0xf5){
+                    n = 4;
+                    if(c == 0xf0) lo = 0x90;            // overlong
+                    else if(c == 0xf4) hi = 0x8f;       // above U+10FFFF
+                } else break;
+                if((size_t)(e - p) < n) break;
+                if(n > 1 && (p[1] < lo || p[1] > hi)) break;
+                size_t i = 2;
+                while(i < n && (p[i] & 0xc0) == 0x80) i++;
+                if(i < n) break;
+                p += n;
+            }
+            return reinterpret_cast<const char*>(p);
+        }
+#ifdef HEX_JSON_X86
+        /* Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte".
+         * Most errors show in a pair of consecutive bytes: three table lookups, by the high nibble of
+         * the first byte, its low nibble and the high nibble of the second, each give the set of
+         * errors that nibble allows, and whatever is in all three is an error. The one thing left,
+         * continuations that should be the third or fourth byte of a sequence, is checked against
+         * the bytes two and three back.
+         */
+        __attribute__((target("ssse3")))
+        static inline __m128i utf8_errors(__m128i in, __m128i prev){
+            const char TOO_SHORT = 1 << 0,      // lead, then not a continuation
+                       TOO_LONG = 1 << 1,       // ASCII, then a continuation
+                       OVERLONG_3 = 1 << 2,     // 11100000 100_____
+                       TOO_LARGE = 1 << 3,      // above U+10FFFF
+                       SURROGATE = 1 << 4,      // 11101101 101_____
+                       OVERLONG_2 = 1 << 5,     // 1100000_ 10______
+                       TOO_LARGE_1000 = 1 << 6, // 11110101 1000____ and up
+                       OVERLONG_4 = 1 << 6,     // 11110000 1000____
+                       TWO_CONTS = (char)(1 << 7), // two continuations
+                       CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+            const __m128i nibble = _mm_set1_epi8(0x0f);
+            const __m128i byte_1_high = _mm_setr_epi8(
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+                TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE,
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+            const __m128i byte_1_low = _mm_setr_epi8(
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY,
+                CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+            const __m128i byte_2_high = _mm_setr_epi8(
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+            __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+            __m128i special = _mm_and_si128(
+                _mm_and_si128(_mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                              _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+            // Saturating subtraction leaves the top bit set only for leads of 3 and 4 byte sequences.
+            __m128i third = _mm_subs_epu8(_mm_alignr_epi8(in, prev, 14), _mm_set1_epi8(0xe0 - 0x80)),
+                    fourth = _mm_subs_epu8(_mm_alignr_epi8(in, prev, 13), _mm_set1_epi8(0xf0 - 0x80));
+            __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(0x80));
+            return _mm_xor_si128(must_continue, special);
+        }
+        /* Whether [str, end) is well-formed UTF-8, 16 bytes at a time. ASCII blocks only have to check
+         * that the block before didn't stop in the middle of a sequence. */
+        __attribute__((target("ssse3")))
+        static bool utf8_valid_ssse3(const char *str, const char *end){
+            // Bytes at least this large near the end of a block start a sequence that goes on.
+            const __m128i last_leads = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                     0xf0 - 1, 0xe0 - 1, 0xc0 - 1);
+            const __m128i zero = _mm_setzero_si128();
+            __m128i prev = zero, unfinished = zero, error = zero;
+            alignas(16) char tail[16] = {};
+            for(;;){
+                __m128i in;
+                if(end - str >= 16){
+                    in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str));
+                    str += 16;
+                } else if(str != end){
+                    // The tail is padded with ASCII, which ends any sequence still going.
+                    memcpy(tail, str, end - str);
+                    in = _mm_load_si128(reinterpret_cast<const __m128i*>(tail));
+                    str = end;
+                } else break;
+                if(_mm_movemask_epi8(in)){
+                    error = _mm_or_si128(error, utf8_errors(in, prev));
+                    unfinished = _mm_subs_epu8(in, last_leads);
+                } else {
+                    error = _mm_or_si128(error, unfinished);
+                    unfinished = zero;
+                }
+                prev = in;
+            }
+            error = _mm_or_si128(error, unfinished);
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) == 0xffff;
+        }
+#endif
+        /* Output for decode_string() that writes into a buffer known to be large enough. */
+        struct char_sink {
+            char *p;
+            inline void operator+=(char c){
+                *p++ = c;
+            }
+            inline void append(const char *first, const char *last){
+                memcpy(p, first, last - first);
+                p += last - first;
+            }
+        };
+        /* Throws the decoded bytes away, for strings that only have to be checked. */
+        struct discard_sink {
+            inline void operator+=(char){}
+            inline void append(const char*, const char*){}
+        };
+
+        /* The four hex digits at p as a number, or something negative if they aren't all hex digits. */
+        static inline int32_t hex4(const char *p){
+            static const int8_t digits[256] = {
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+                -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            };
+            int32_t a = digits[(unsigned char)p[0]], b = digits[(unsigned char)p[1]],
+                    c = digits[(unsigned char)p[2]], d = digits[(unsigned char)p[3]];
+            // Any -1 makes the or negative, and the digits themselves never are.
+            return (a | b | c | d) < 0 ? -1 : a << 12 | b << 8 | c << 4 | d;
+        }
+        /* Writes the UTF-8 form of a code point (not a surrogate) to out, returns how many bytes. */
+        static inline size_t encode_utf8(uint32_t cp, char *out){
+            if(cp < 0x80){
+                out[0] = cp;
+                return 1;
+            }
+            if(cp < 0x800){
+                // 110xxxxx 10xxxxxx
+                out[0] = 0xc0 | cp >> 6;
+                out[1] = 0x80 | (cp & 0x3f);
+                return 2;
+            }
+            if(cp < 0x10000){
+                // 1110xxxx 10xxxxxx 10xxxxxx
+                out[0] = 0xe0 | cp >> 12;
+                out[1] = 0x80 | (cp >> 6 & 0x3f);
+                out[2] = 0x80 | (cp & 0x3f);
+                return 3;
+            }
+            // 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+            out[0] = 0xf0 | cp >> 18;
+            out[1] = 0x80 | (cp >> 12 & 0x3f);
+            out[2] = 0x80 | (cp >> 6 & 0x3f);
+            out[3] = 0x80 | (cp & 0x3f);
+            return 4;
+        }
+
+        /* Decodes the body of a string (starting right after the opening quote) into `result`.
+         * Runs of plain characters are appended in one go, escapes one at a time.
+         * Returns a pointer directly _after_ the closing quote. If the string was invalid, the pointer
+         * will be (the position of the error) + length + 1, see parse_string_incomplete().
+         */
+        template<typename Out>
+        static const char *decode_string(const char *str, const char *end, size_t length, Out& result){
+            /* This is not actually that simple. 
+             * Excerpt from RFC:
+             * char = unescaped /
+                  escape (
+                      %x22 /          ; "    quotation mark  U+0022
+                      %x5C /          ; \    reverse solidus U+005C
+                      %x2F /          ; /    solidus         U+002F
+                      %x62 /          ; b    backspace       U+0008
+                      %x66 /          ; f    form feed       U+000C
+                      %x6E /          ; n    line feed       U+000A
+                      %x72 /          ; r    carriage return U+000D
+                      %x74 /          ; t    tab             U+0009
+                      %x75 4HEXDIG )  ; uXXXX
+              */
+            for(;;){
+                const char *run = str;
+                while(str != end && is_plain(*str)) str++;
+                result.append(run, str);
+                if(str == end) return str + length + 1;
+                // Get rid of last quote.
+                if(*str == '"') return str + 1;
+                /* Annoying part. */
+                if(*str != '\\'){
+                    // Control characters have to be escaped.
+                    return str + length + 1;
+                }
+                HEX_JSON_STAT(stats->escapes++);
+                str++;
+                if(str == end) return str + length + 1;
+                /* Literally mean themselves. */
+                if(*str == '"' || *str == '\\' || *str == '/'){
+                    result += *str;
+                /* Check the RFC excerpt above. Don't mean themselves. */
+                } else if(*str == 'b'){
+                    result += (char)0x08;
+                } else if(*str == 'f'){
+                    result += (char)0x0c;
+                } else if(*str == 'n'){
+                    result += (char)0x0a;
+                } else if(*str == 'r'){
+                    result += (char)0x0d;
+                } else if(*str == 't'){
+                    result += (char)0x09;
+                } else if(*str == 'u') {
+                    // In format \uXXXX, or two of them for a code point past U+FFFF.
+                    const char *escape = str - 1;
+                    int32_t codepoint = end - str > 4 ? hex4(str + 1) : -1;
+                    str += 4;
+                    if((codepoint & 0xfc00) == 0xd800){
+                        // A high surrogate has to be followed by a low one.
+                        int32_t low = end - str > 6 && str[1] == '\\' && str[2] == 'u' ? hex4(str + 3) : -1;
+                        if((low & 0xfc00) != 0xdc00) return escape + length + 1;
+                        codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                        str += 6;
+                    } else if(codepoint < 0 || (codepoint & 0xfc00) == 0xdc00){
+                        return escape + length + 1;
+                    }
+                    char utf8[4];
+                    size_t n = encode_utf8(codepoint, utf8);
+                    result.append(utf8, utf8 + n);
+                } else {
+                    // Invalid.
+                    return str + length + 1;
+                }
+                str++;
+            }
+        }
+
+        static inline bool is_op(char c){
+            return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+        }
+
+        /* Everything the grammar needs while it walks one input. */
+        struct sax_state {
+            structural_index index;
+            const char *end;
+            /* Strings with escapes are decoded into `scratch`, which is reused, or, if `side` is set,
+             * into a buffer allocated from it, so the string stays valid after the callback. */
+            string_t scratch;
+            std::pmr::memory_resource *side;
+            const char *error = nullptr;
+            parse_error code = PARSE_OK;    // SYNTAX_ERROR, unless something else is said
+            bool decode = true;             // otherwise escaped strings and numbers are only checked, and come out as "" and 0
+            /* The containers the grammar is in, a bit per level that's set for objects.
+             * Room for max_depth of them is made up front. */
+            size_t max_depth;
+            uint64_t small_stack[16];
+            std::unique_ptr<uint64_t[]> big_stack;
+            uint64_t *containers = small_stack;
+            sax_state(const char *input, const char *end, std::pmr::memory_resource *side,
+                      size_t max_depth = default_max_depth)
+                // Small inputs don't need a whole window of token slots.
+                : index(input, end, structural_index::window_for(input, end)),
+                  end(end), side(side), max_depth(max_depth) {
+                if(max_depth > 64 * std::size(small_stack)){
+                    big_stack.reset(new uint64_t[(max_depth + 63) / 64]);
+                    containers = big_stack.get();
+                }
+            }
+            /* Starts over on [input, end), keeping the buffers. The index only ever gets a bigger window. */
+            void reset(const char *input, const char *end, char *minified = nullptr){
+                size_t window = structural_index::window_for(input, end);
+                if(window > index.window_size()) index = structural_index(window);
+                index.reset(input, end, minified);
+                this->end = end;
+                error = nullptr;
+                code = PARSE_OK;
+            }
+            inline void set_container(size_t depth, bool object) noexcept {
+                uint64_t bit = (uint64_t)1 << (depth & 63), &word = containers[depth >> 6];
+                word = object ? word | bit : word & ~bit;
+            }
+            inline bool in_object(size_t depth) const noexcept {
+                return containers[depth >> 6] >> (depth & 63) & 1;
+            }
+        };
+
+        /* Reads the string starting at the opening quote `str` into `result`.
+         * The structural index already knows where the closing quote is. Most strings have nothing
+         * to decode, and those point straight into the input.
+         */
+        static bool read_string(sax_state& st, const char *str, std::string_view& result){
+            const char *close = st.index.next();
+            if(close == st.end){
+                st.error = st.end;
+                return false;
+            }
+            HEX_JSON_TIME(STRINGS);
+            HEX_JSON_STAT(stats->string_bytes += close - str - 1);
+            bool ascii;
+            const char *special = find_special(str + 1, close, ascii);
+            if(!ascii || special != close){
+                const char *bad = find_invalid_utf8(str + 1, close);
+                if(bad != close){
+                    st.error = bad;
+                    return false;
+                }
+            }
+            if(special == close){
+                result = std::string_view(str + 1, close - str - 1);
+                return true;
+            }
+            const char *next;
+            if(!st.decode){
+                discard_sink out;
+                next = decode_string(special, st.end, st.end - str, out);
+                result = std::string_view();
+            } else if(st.side){
+                // Decoding never makes a string longer, so the raw length is all the buffer needs.
+                HEX_JSON_STAT(stats->allocations++, stats->allocated_bytes += close - str);
+                char *buf = static_cast<char*>(st.side->allocate(close - str, 1));
+                char_sink out{buf};
+                out.append(str + 1, special);
+                next = decode_string(special, st.end, st.end - str, out);
+                result = std::string_view(buf, out.p - buf);
+            } else {
+                st.scratch.assign(str + 1, special);
+                next = decode_string(special, st.end, st.end - str, st.scratch);
+                result = st.scratch;
+            }
+            if(next > st.end){
+                st.error = next - (st.end - str) - 1;
+                return false;
+            }
+            return true;
+        }
+
+        static inline bool is_digit(char c){
+            return '0' <= c && c <= '9';
+        }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        /* SWAR: whether the 8 bytes of `v` are all ASCII digits. */
+        static inline bool is_eight_digits(uint64_t v){
+            return ((v & 0xf0f0f0f0f0f0f0f0) | (((v + 0x0606060606060606) & 0xf0f0f0f0f0f0f0f0) >> 4)) == 0x3333333333333333;
+        }
+        /* SWAR: the value of 8 ASCII digits, combining pairs, then quads, then halves. */
+        static inline uint32_t parse_eight_digits(uint64_t v){
+            v -= 0x3030303030303030;
+            v = v * 10 + (v >> 8);
+            v = ((v & 0x000000ff000000ff) * 0x000f424000000064 + ((v >> 16) & 0x000000ff000000ff) * 0x0000271000000001) >> 32;
+            return (uint32_t)v;
+        }
+#endif
+        /* Reads a run of digits, adding them to `m` while it has room for them (19 digits).
+         * `digits` counts the digits in `m` so far, `dropped` the ones that didn't fit. */
+        static inline const char *read_digits(const char *p, const char *end, uint64_t& m, int& digits, int& dropped){
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            while(end - p >= 8 && digits <= 11){
+                uint64_t v;
+                memcpy(&v, p, 8);
+                if(!is_eight_digits(v)) break;
+                m = m * 100000000 + parse_eight_digits(v);
+                digits += 8;
+                p += 8;
+            }
+#endif
+            for(; p != end && is_digit(*p); p++){
+                if(digits < 19){
+                    m = m * 10 + (*p - '0');
+                    digits++;
+                } else {
+                    dropped++;
+                }
+            }
+            return p;
+        }
+
+#ifdef __SIZEOF_INT128__
+        /* m * 10^q, correctly rounded, for a significand of at most 19 digits (Eisel-Lemire).
+         * m is multiplied by a 128-bit truncation of 5^q and the top bits of the product, with the
+         * binary exponent worked out from q, are the double. 128 bits are always enough to round
+         * exactly (Mushtak and Lemire, "Fast Number Parsing Without Fallback").
+         */
+        static double eisel_lemire(uint64_t m, int64_t q, bool negative){
+            // 5^q for q in [-342, 308], normalized so the top bit is set: high word, then low word.
+            static const uint64_t powers_of_five[] = {
+                0xeef453d6923bd65a, 0x113faa2906a13b3f,
+                0x9558b4661b6565f8, 0x4ac7ca59a424c507,
+                0xbaaee17fa23ebf76, 0x5d79bcf00d2df649,
+                0xe95a99df8ace6f53, 0xf4d82c2c107973dc,
+                0x91d8a02bb6c10594, 0x79071b9b8a4be869,
+                0xb64ec836a47146f9, 0x9748e2826cdee284,
+                0xe3e27a444d8d98b7, 0xfd1b1b2308169b25,
+                0x8e6d8c6ab0787f72, 0xfe30f0f5e50e20f7,
+                0xb208ef855c969f4f, 0xbdbd2d335e51a935,
+                0xde8b2b66b3bc4723, 0xad2c788035e61382,
+                0x8b16fb203055ac76, 0x4c3bcb5021afcc31,
+                0xaddcb9e83c6b1793, 0xdf4abe242a1bbf3d,
+                0xd953e8624b85dd78, 0xd71d6dad34a2af0d,
+                0x87d4713d6f33aa6b, 0x8672648c40e5ad68,
+                0xa9c98d8ccb009506, 0x680efdaf511f18c2,
+                0xd43bf0effdc0ba48, 0x0212bd1b2566def2,
+                0x84a57695fe98746d, 0x014bb630f7604b57,
+                0xa5ced43b7e3e9188, 0x419ea3bd35385e2d,
+                0xcf42894a5dce35ea, 0x52064cac828675b9,
+                0x818995ce7aa0e1b2, 0x7343efebd1940993,
+                0xa1ebfb4219491a1f, 0x1014ebe6c5f90bf8,
+                0xca66fa129f9b60a6, 0xd41a26e077774ef6,
+                0xfd00b897478238d0, 0x8920b098955522b4,
+                0x9e20735e8cb16382, 0x55b46e5f5d5535b0,
+                0xc5a890362fddbc62, 0xeb2189f734aa831d,
+                0xf712b443bbd52b7b, 0xa5e9ec7501d523e4,
+                0x9a6bb0aa55653b2d, 0x47b233c92125366e,
+                0xc1069cd4eabe89f8, 0x999ec0bb696e840a,
+                0xf148440a256e2c76, 0xc00670ea43ca250d,
+                0x96cd2a865764dbca, 0x380406926a5e5728,
+                0xbc807527ed3e12bc, 0xc605083704f5ecf2,
+                0xeba09271e88d976b, 0xf7864a44c633682e,
+                0x93445b8731587ea3, 0x7ab3ee6afbe0211d,
+                0xb8157268fdae9e4c, 0x5960ea05bad82964,
+                0xe61acf033d1a45df, 0x6fb92487298e33bd,
+                0x8fd0c16206306bab, 0xa5d3b6d479f8e056,
+                0xb3c4f1ba87bc8696, 0x8f48a4899877186c,
+                0xe0b62e2929aba83c, 0x331acdabfe94de87,
+                0x8c71dcd9ba0b4925, 0x9ff0c08b7f1d0b14,
+                0xaf8e5410288e1b6f, 0x07ecf0ae5ee44dd9,
+                0xdb71e91432b1a24a, 0xc9e82cd9f69d6150,
+                0x892731ac9faf056e, 0xbe311c083a225cd2,
+                0xab70fe17c79ac6ca, 0x6dbd630a48aaf406,
+                0xd64d3d9db981787d, 0x092cbbccdad5b108,
+                0x85f0468293f0eb4e, 0x25bbf56008c58ea5,
+                0xa76c582338ed2621, 0xaf2af2b80af6f24e,
+                0xd1476e2c07286faa, 0x1af5af660db4aee1,
+                0x82cca4db847945ca, 0x50d98d9fc890ed4d,
+                0xa37fce126597973c, 0xe50ff107bab528a0,
+                0xcc5fc196fefd7d0c, 0x1e53ed49a96272c8,
+                0xff77b1fcbebcdc4f, 0x25e8e89c13bb0f7a,
+                0x9faacf3df73609b1, 0x77b191618c54e9ac,
+                0xc795830d75038c1d, 0xd59df5b9ef6a2417,
+                0xf97ae3d0d2446f25, 0x4b0573286b44ad1d,
+                0x9becce62836ac577, 0x4ee367f9430aec32,
+                0xc2e801fb244576d5, 0x229c41f793cda73f,
+                0xf3a20279ed56d48a, 0x6b43527578c1110f,
+                0x9845418c345644d6, 0x830a13896b78aaa9,
+                0xbe5691ef416bd60c, 0x23cc986bc656d553,
+                0xedec366b11c6cb8f, 0x2cbfbe86b7ec8aa8,
+                0x94b3a202eb1c3f39, 0x7bf7d71432f3d6a9,
+                0xb9e08a83a5e34f07, 0xdaf5ccd93fb0cc53,
+                0xe858ad248f5c22c9, 0xd1b3400f8f9cff68,
+                0x91376c36d99995be, 0x23100809b9c21fa1,
+                0xb58547448ffffb2d, 0xabd40a0c2832a78a,
+                0xe2e69915b3fff9f9, 0x16c90c8f323f516c,
+                0x8dd01fad907ffc3b, 0xae3da7d97f6792e3,
+                0xb1442798f49ffb4a, 0x99cd11cfdf41779c,
+                0xdd95317f31c7fa1d, 0x40405643d711d583,
+                0x8a7d3eef7f1cfc52, 0x482835ea666b2572,
+                0xad1c8eab5ee43b66, 0xda3243650005eecf,
+                0xd863b256369d4a40, 0x90bed43e40076a82,
+                0x873e4f75e2224e68, 0x5a7744a6e804a291,
+                0xa90de3535aaae202, 0x711515d0a205cb36,
+                0xd3515c2831559a83, 0x0d5a5b44ca873e03,
+                0x8412d9991ed58091, 0xe858790afe9486c2,
+                0xa5178fff668ae0b6, 0x626e974dbe39a872,
+                0xce5d73ff402d98e3, 0xfb0a3d212dc8128f,
+                0x80fa687f881c7f8e, 0x7ce66634bc9d0b99,
+                0xa139029f6a239f72, 0x1c1fffc1ebc44e80,
+                0xc987434744ac874e, 0xa327ffb266b56220,
+                0xfbe9141915d7a922, 0x4bf1ff9f0062baa8,
+                0x9d71ac8fada6c9b5, 0x6f773fc3603db4a9,
+                0xc4ce17b399107c22, 0xcb550fb4384d21d3,
+                0xf6019da07f549b2b, 0x7e2a53a146606a48,
+                0x99c102844f94e0fb, 0x2eda7444cbfc426d,
+                0xc0314325637a1939, 0xfa911155fefb5308,
+                0xf03d93eebc589f88, 0x793555ab7eba27ca,
+                0x96267c7535b763b5, 0x4bc1558b2f3458de,
+                0xbbb01b9283253ca2, 0x9eb1aaedfb016f16,
+                0xea9c227723ee8bcb, 0x465e15a979c1cadc,
+                0x92a1958a7675175f, 0x0bfacd89ec191ec9,
+                0xb749faed14125d36, 0xcef980ec671f667b,
+                0xe51c79a85916f484, 0x82b7e12780e7401a,
+                0x8f31cc0937ae58d2, 0xd1b2ecb8b0908810,
+                0xb2fe3f0b8599ef07, 0x861fa7e6dcb4aa15,
+                0xdfbdcece67006ac9, 0x67a791e093e1d49a,
+                0x8bd6a141006042bd, 0xe0c8bb2c5c6d24e0,
+                0xaecc49914078536d, 0x58fae9f773886e18,
+                0xda7f5bf590966848, 0xaf39a475506a899e,
+                0x888f99797a5e012d, 0x6d8406c952429603,
+                0xaab37fd7d8f58178, 0xc8e5087ba6d33b83,
+                0xd5605fcdcf32e1d6, 0xfb1e4a9a90880a64,
+                0x855c3be0a17fcd26, 0x5cf2eea09a55067f,
+                0xa6b34ad8c9dfc06f, 0xf42faa48c0ea481e,
+                0xd0601d8efc57b08b, 0xf13b94daf124da26,
+                0x823c12795db6ce57, 0x76c53d08d6b70858,
+                0xa2cb1717b52481ed, 0x54768c4b0c64ca6e,
+                0xcb7ddcdda26da268, 0xa9942f5dcf7dfd09,
+                0xfe5d54150b090b02, 0xd3f93b35435d7c4c,
+                0x9efa548d26e5a6e1, 0xc47bc5014a1a6daf,
+                0xc6b8e9b0709f109a, 0x359ab6419ca1091b,
+                0xf867241c8cc6d4c0, 0xc30163d203c94b62,
+                0x9b407691d7fc44f8, 0x79e0de63425dcf1d,
+                0xc21094364dfb5636, 0x985915fc12f542e4,
+                0xf294b943e17a2bc4, 0x3e6f5b7b17b2939d,
+                0x979cf3ca6cec5b5a, 0xa705992ceecf9c42,
+                0xbd8430bd08277231, 0x50c6ff782a838353,
+                0xece53cec4a314ebd, 0xa4f8bf5635246428,
+                0x940f4613ae5ed136, 0x871b7795e136be99,
+                0xb913179899f68584, 0x28e2557b59846e3f,
+                0xe757dd7ec07426e5, 0x331aeada2fe589cf,
+                0x9096ea6f3848984f, 0x3ff0d2c85def7621,
+                0xb4bca50b065abe63, 0x0fed077a756b53a9,
+                0xe1ebce4dc7f16dfb, 0xd3e8495912c62894,
+                0x8d3360f09cf6e4bd, 0x64712dd7abbbd95c,
+                0xb080392cc4349dec, 0xbd8d794d96aacfb3,
+                0xdca04777f541c567, 0xecf0d7a0fc5583a0,
+                0x89e42caaf9491b60, 0xf41686c49db57244,
+                0xac5d37d5b79b6239, 0x311c2875c522ced5,
+                0xd77485cb25823ac7, 0x7d633293366b828b,
+                0x86a8d39ef77164bc, 0xae5dff9c02033197,
+                0xa8530886b54dbdeb, 0xd9f57f830283fdfc,
+                0xd267caa862a12d66, 0xd072df63c324fd7b,
+                0x8380dea93da4bc60, 0x4247cb9e59f71e6d,
+                0xa46116538d0deb78, 0x52d9be85f074e608,
+                0xcd795be870516656, 0x67902e276c921f8b,
+                0x806bd9714632dff6, 0x00ba1cd8a3db53b6,
+                0xa086cfcd97bf97f3, 0x80e8a40eccd228a4,
+                0xc8a883c0fdaf7df0, 0x6122cd128006b2cd,
+                0xfad2a4b13d1b5d6c, 0x796b805720085f81,
+                0x9cc3a6eec6311a63, 0xcbe3303674053bb0,
+                0xc3f490aa77bd60fc, 0xbedbfc4411068a9c,
+                0xf4f1b4d515acb93b, 0xee92fb5515482d44,
+                0x991711052d8bf3c5, 0x751bdd152d4d1c4a,
+                0xbf5cd54678eef0b6, 0xd262d45a78a0635d,
+                0xef340a98172aace4, 0x86fb897116c87c34,
+                0x9580869f0e7aac0e, 0xd45d35e6ae3d4da0,
+                0xbae0a846d2195712, 0x8974836059cca109,
+                0xe998d258869facd7, 0x2bd1a438703fc94b,
+                0x91ff83775423cc06, 0x7b6306a34627ddcf,
+                0xb67f6455292cbf08, 0x1a3bc84c17b1d542,
+                0xe41f3d6a7377eeca, 0x20caba5f1d9e4a93,
+                0x8e938662882af53e, 0x547eb47b7282ee9c,
+                0xb23867fb2a35b28d, 0xe99e619a4f23aa43,
+                0xdec681f9f4c31f31, 0x6405fa00e2ec94d4,
+                0x8b3c113c38f9f37e, 0xde83bc408dd3dd04,
+                0xae0b158b4738705e, 0x9624ab50b148d445,
+                0xd98ddaee19068c76, 0x3badd624dd9b0957,
+                0x87f8a8d4cfa417c9, 0xe54ca5d70a80e5d6,
+                0xa9f6d30a038d1dbc, 0x5e9fcf4ccd211f4c,
+                0xd47487cc8470652b, 0x7647c3200069671f,
+                0x84c8d4dfd2c63f3b, 0x29ecd9f40041e073,
+                0xa5fb0a17c777cf09, 0xf468107100525890,
+                0xcf79cc9db955c2cc, 0x7182148d4066eeb4,
+                0x81ac1fe293d599bf, 0xc6f14cd848405530,
+                0xa21727db38cb002f, 0xb8ada00e5a506a7c,
+                0xca9cf1d206fdc03b, 0xa6d90811f0e4851c,
+                0xfd442e4688bd304a, 0x908f4a166d1da663,
+                0x9e4a9cec15763e2e, 0x9a598e4e043287fe,
+                0xc5dd44271ad3cdba, 0x40eff1e1853f29fd,
+                0xf7549530e188c128, 0xd12bee59e68ef47c,
+                0x9a94dd3e8cf578b9, 0x82bb74f8301958ce,
+                0xc13a148e3032d6e7, 0xe36a52363c1faf01,
+                0xf18899b1bc3f8ca1, 0xdc44e6c3cb279ac1,
+                0x96f5600f15a7b7e5, 0x29ab103a5ef8c0b9,
+                0xbcb2b812db11a5de, 0x7415d448f6b6f0e7,
+                0xebdf661791d60f56, 0x111b495b3464ad21,
+                0x936b9fcebb25c995, 0xcab10dd900beec34,
+                0xb84687c269ef3bfb, 0x3d5d514f40eea742,
+                0xe65829b3046b0afa, 0x0cb4a5a3112a5112,
+                0x8ff71a0fe2c2e6dc, 0x47f0e785eaba72ab,
+                0xb3f4e093db73a093, 0x59ed216765690f56,
+                0xe0f218b8d25088b8, 0x306869c13ec3532c,
+                0x8c974f7383725573, 0x1e414218c73a13fb,
+                0xafbd2350644eeacf, 0xe5d1929ef90898fa,
+                0xdbac6c247d62a583, 0xdf45f746b74abf39,
+                0x894bc396ce5da772, 0x6b8bba8c328eb783,
+                0xab9eb47c81f5114f, 0x066ea92f3f326564,
+                0xd686619ba27255a2, 0xc80a537b0efefebd,
+                0x8613fd0145877585, 0xbd06742ce95f5f36,
+                0xa798fc4196e952e7, 0x2c48113823b73704,
+                0xd17f3b51fca3a7a0, 0xf75a15862ca504c5,
+                0x82ef85133de648c4, 0x9a984d73dbe722fb,
+                0xa3ab66580d5fdaf5, 0xc13e60d0d2e0ebba,
+                0xcc963fee10b7d1b3, 0x318df905079926a8,
+                0xffbbcfe994e5c61f, 0xfdf17746497f7052,
+                0x9fd561f1fd0f9bd3, 0xfeb6ea8bedefa633,
+                0xc7caba6e7c5382c8, 0xfe64a52ee96b8fc0,
+                0xf9bd690a1b68637b, 0x3dfdce7aa3c673b0,
+                0x9c1661a651213e2d, 0x06bea10ca65c084e,
+                0xc31bfa0fe5698db8, 0x486e494fcff30a62,
+                0xf3e2f893dec3f126, 0x5a89dba3c3efccfa,
+                0x986ddb5c6b3a76b7, 0xf89629465a75e01c,
+                0xbe89523386091465, 0xf6bbb397f1135823,
+                0xee2ba6c0678b597f, 0x746aa07ded582e2c,
+                0x94db483840b717ef, 0xa8c2a44eb4571cdc,
+                0xba121a4650e4ddeb, 0x92f34d62616ce413,
+                0xe896a0d7e51e1566, 0x77b020baf9c81d17,
+                0x915e2486ef32cd60, 0x0ace1474dc1d122e,
+                0xb5b5ada8aaff80b8, 0x0d819992132456ba,
+                0xe3231912d5bf60e6, 0x10e1fff697ed6c69,
+                0x8df5efabc5979c8f, 0xca8d3ffa1ef463c1,
+                0xb1736b96b6fd83b3, 0xbd308ff8a6b17cb2,
+                0xddd0467c64bce4a0, 0xac7cb3f6d05ddbde,
+                0x8aa22c0dbef60ee4, 0x6bcdf07a423aa96b,
+                0xad4ab7112eb3929d, 0x86c16c98d2c953c6,
+                0xd89d64d57a607744, 0xe871c7bf077ba8b7,
+                0x87625f056c7c4a8b, 0x11471cd764ad4972,
+                0xa93af6c6c79b5d2d, 0xd598e40d3dd89bcf,
+                0xd389b47879823479, 0x4aff1d108d4ec2c3,
+                0x843610cb4bf160cb, 0xcedf722a585139ba,
+                0xa54394fe1eedb8fe, 0xc2974eb4ee658828,
+                0xce947a3da6a9273e, 0x733d226229feea32,
+                0x811ccc668829b887, 0x0806357d5a3f525f,
+                0xa163ff802a3426a8, 0xca07c2dcb0cf26f7,
+                0xc9bcff6034c13052, 0xfc89b393dd02f0b5,
+                0xfc2c3f3841f17c67, 0xbbac2078d443ace2,
+                0x9d9ba7832936edc0, 0xd54b944b84aa4c0d,
+                0xc5029163f384a931, 0x0a9e795e65d4df11,
+                0xf64335bcf065d37d, 0x4d4617b5ff4a16d5,
+                0x99ea0196163fa42e, 0x504bced1bf8e4e45,
+                0xc06481fb9bcf8d39, 0xe45ec2862f71e1d6,
+                0xf07da27a82c37088, 0x5d767327bb4e5a4c,
+                0x964e858c91ba2655, 0x3a6a07f8d510f86f,
+                0xbbe226efb628afea, 0x890489f70a55368b,
+                0xeadab0aba3b2dbe5, 0x2b45ac74ccea842e,
+                0x92c8ae6b464fc96f, 0x3b0b8bc90012929d,
+                0xb77ada0617e3bbcb, 0x09ce6ebb40173744,
+                0xe55990879ddcaabd, 0xcc420a6a101d0515,
+                0x8f57fa54c2a9eab6, 0x9fa946824a12232d,
+                0xb32df8e9f3546564, 0x47939822dc96abf9,
+                0xdff9772470297ebd, 0x59787e2b93bc56f7,
+                0x8bfbea76c619ef36, 0x57eb4edb3c55b65a,
+                0xaefae51477a06b03, 0xede622920b6b23f1,
+                0xdab99e59958885c4, 0xe95fab368e45eced,
+                0x88b402f7fd75539b, 0x11dbcb0218ebb414,
+                0xaae103b5fcd2a881, 0xd652bdc29f26a119,
+                0xd59944a37c0752a2, 0x4be76d3346f0495f,
+                0x857fcae62d8493a5, 0x6f70a4400c562ddb,
+                0xa6dfbd9fb8e5b88e, 0xcb4ccd500f6bb952,
+                0xd097ad07a71f26b2, 0x7e2000a41346a7a7,
+                0x825ecc24c873782f, 0x8ed400668c0c28c8,
+                0xa2f67f2dfa90563b, 0x728900802f0f32fa,
+                0xcbb41ef979346bca, 0x4f2b40a03ad2ffb9,
+                0xfea126b7d78186bc, 0xe2f610c84987bfa8,
+                0x9f24b832e6b0f436, 0x0dd9ca7d2df4d7c9,
+                0xc6ede63fa05d3143, 0x91503d1c79720dbb,
+                0xf8a95fcf88747d94, 0x75a44c6397ce912a,
+                0x9b69dbe1b548ce7c, 0xc986afbe3ee11aba,
+                0xc24452da229b021b, 0xfbe85badce996168,
+                0xf2d56790ab41c2a2, 0xfae27299423fb9c3,
+                0x97c560ba6b0919a5, 0xdccd879fc967d41a,
+                0xbdb6b8e905cb600f, 0x5400e987bbc1c920,
+                0xed246723473e3813, 0x290123e9aab23b68,
+                0x9436c0760c86e30b, 0xf9a0b6720aaf6521,
+                0xb94470938fa89bce, 0xf808e40e8d5b3e69,
+                0xe7958cb87392c2c2, 0xb60b1d1230b20e04,
+                0x90bd77f3483bb9b9, 0xb1c6f22b5e6f48c2,
+                0xb4ecd5f01a4aa828, 0x1e38aeb6360b1af3,
+                0xe2280b6c20dd5232, 0x25c6da63c38de1b0,
+                0x8d590723948a535f, 0x579c487e5a38ad0e,
+                0xb0af48ec79ace837, 0x2d835a9df0c6d851,
+                0xdcdb1b2798182244, 0xf8e431456cf88e65,
+                0x8a08f0f8bf0f156b, 0x1b8e9ecb641b58ff,
+                0xac8b2d36eed2dac5, 0xe272467e3d222f3f,
+                0xd7adf884aa879177, 0x5b0ed81dcc6abb0f,
+                0x86ccbb52ea94baea, 0x98e947129fc2b4e9,
+                0xa87fea27a539e9a5, 0x3f2398d747b36224,
+                0xd29fe4b18e88640e, 0x8eec7f0d19a03aad,
+                0x83a3eeeef9153e89, 0x1953cf68300424ac,
+                0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7,
+                0xcdb02555653131b6, 0x3792f412cb06794d,
+                0x808e17555f3ebf11, 0xe2bbd88bbee40bd0,
+                0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4,
+                0xc8de047564d20a8b, 0xf245825a5a445275,
+                0xfb158592be068d2e, 0xeed6e2f0f0d56712,
+                0x9ced737bb6c4183d, 0x55464dd69685606b,
+                0xc428d05aa4751e4c, 0xaa97e14c3c26b886,
+                0xf53304714d9265df, 0xd53dd99f4b3066a8,
+                0x993fe2c6d07b7fab, 0xe546a8038efe4029,
+                0xbf8fdb78849a5f96, 0xde98520472bdd033,
+                0xef73d256a5c0f77c, 0x963e66858f6d4440,
+                0x95a8637627989aad, 0xdde7001379a44aa8,
+                0xbb127c53b17ec159, 0x5560c018580d5d52,
+                0xe9d71b689dde71af, 0xaab8f01e6e10b4a6,
+                0x9226712162ab070d, 0xcab3961304ca70e8,
+                0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22,
+                0xe45c10c42a2b3b05, 0x8cb89a7db77c506a,
+                0x8eb98a7a9a5b04e3, 0x77f3608e92adb242,
+                0xb267ed1940f1c61c, 0x55f038b237591ed3,
+                0xdf01e85f912e37a3, 0x6b6c46dec52f6688,
+                0x8b61313bbabce2c6, 0x2323ac4b3b3da015,
+                0xae397d8aa96c1b77, 0xabec975e0a0d081a,
+                0xd9c7dced53c72255, 0x96e7bd358c904a21,
+                0x881cea14545c7575, 0x7e50d64177da2e54,
+                0xaa242499697392d2, 0xdde50bd1d5d0b9e9,
+                0xd4ad2dbfc3d07787, 0x955e4ec64b44e864,
+                0x84ec3c97da624ab4, 0xbd5af13bef0b113e,
+                0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e,
+                0xcfb11ead453994ba, 0x67de18eda5814af2,
+                0x81ceb32c4b43fcf4, 0x80eacf948770ced7,
+                0xa2425ff75e14fc31, 0xa1258379a94d028d,
+                0xcad2f7f5359a3b3e, 0x096ee45813a04330,
+                0xfd87b5f28300ca0d, 0x8bca9d6e188853fc,
+                0x9e74d1b791e07e48, 0x775ea264cf55347e,
+                0xc612062576589dda, 0x95364afe032a819e,
+                0xf79687aed3eec551, 0x3a83ddbd83f52205,
+                0x9abe14cd44753b52, 0xc4926a9672793543,
+                0xc16d9a0095928a27, 0x75b7053c0f178294,
+                0xf1c90080baf72cb1, 0x5324c68b12dd6339,
+                0x971da05074da7bee, 0xd3f6fc16ebca5e04,
+                0xbce5086492111aea, 0x88f4bb1ca6bcf585,
+                0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6,
+                0x9392ee8e921d5d07, 0x3aff322e62439fd0,
+                0xb877aa3236a4b449, 0x09befeb9fad487c3,
+                0xe69594bec44de15b, 0x4c2ebe687989a9b4,
+                0x901d7cf73ab0acd9, 0x0f9d37014bf60a11,
+                0xb424dc35095cd80f, 0x538484c19ef38c95,
+                0xe12e13424bb40e13, 0x2865a5f206b06fba,
+                0x8cbccc096f5088cb, 0xf93f87b7442e45d4,
+                0xafebff0bcb24aafe, 0xf78f69a51539d749,
+                0xdbe6fecebdedd5be, 0xb573440e5a884d1c,
+                0x89705f4136b4a597, 0x31680a88f8953031,
+                0xabcc77118461cefc, 0xfdc20d2b36ba7c3e,
+                0xd6bf94d5e57a42bc, 0x3d32907604691b4d,
+                0x8637bd05af6c69b5, 0xa63f9a49c2c1b110,
+                0xa7c5ac471b478423, 0x0fcf80dc33721d54,
+                0xd1b71758e219652b, 0xd3c36113404ea4a9,
+                0x83126e978d4fdf3b, 0x645a1cac083126ea,
+                0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4,
+                0xcccccccccccccccc, 0xcccccccccccccccd,
+                0x8000000000000000, 0x0000000000000000,
+                0xa000000000000000, 0x0000000000000000,
+                0xc800000000000000, 0x0000000000000000,
+                0xfa00000000000000, 0x0000000000000000,
+                0x9c40000000000000, 0x0000000000000000,
+                0xc350000000000000, 0x0000000000000000,
+                0xf424000000000000, 0x0000000000000000,
+                0x9896800000000000, 0x0000000000000000,
+                0xbebc200000000000, 0x0000000000000000,
+                0xee6b280000000000, 0x0000000000000000,
+                0x9502f90000000000, 0x0000000000000000,
+                0xba43b74000000000, 0x0000000000000000,
+                0xe8d4a51000000000, 0x0000000000000000,
+                0x9184e72a00000000, 0x0000000000000000,
+                0xb5e620f480000000, 0x0000000000000000,
+                0xe35fa931a0000000, 0x0000000000000000,
+                0x8e1bc9bf04000000, 0x0000000000000000,
+                0xb1a2bc2ec5000000, 0x0000000000000000,
+                0xde0b6b3a76400000, 0x0000000000000000,
+                0x8ac7230489e80000, 0x0000000000000000,
+                0xad78ebc5ac620000, 0x0000000000000000,
+                0xd8d726b7177a8000, 0x0000000000000000,
+                0x878678326eac9000, 0x0000000000000000,
+                0xa968163f0a57b400, 0x0000000000000000,
+                0xd3c21bcecceda100, 0x0000000000000000,
+                0x84595161401484a0, 0x0000000000000000,
+                0xa56fa5b99019a5c8, 0x0000000000000000,
+                0xcecb8f27f4200f3a, 0x0000000000000000,
+                0x813f3978f8940984, 0x4000000000000000,
+                0xa18f07d736b90be5, 0x5000000000000000,
+                0xc9f2c9cd04674ede, 0xa400000000000000,
+                0xfc6f7c4045812296, 0x4d00000000000000,
+                0x9dc5ada82b70b59d, 0xf020000000000000,
+                0xc5371912364ce305, 0x6c28000000000000,
+                0xf684df56c3e01bc6, 0xc732000000000000,
+                0x9a130b963a6c115c, 0x3c7f400000000000,
+                0xc097ce7bc90715b3, 0x4b9f100000000000,
+                0xf0bdc21abb48db20, 0x1e86d40000000000,
+                0x96769950b50d88f4, 0x1314448000000000,
+                0xbc143fa4e250eb31, 0x17d955a000000000,
+                0xeb194f8e1ae525fd, 0x5dcfab0800000000,
+                0x92efd1b8d0cf37be, 0x5aa1cae500000000,
+                0xb7abc627050305ad, 0xf14a3d9e40000000,
+                0xe596b7b0c643c719, 0x6d9ccd05d0000000,
+                0x8f7e32ce7bea5c6f, 0xe4820023a2000000,
+                0xb35dbf821ae4f38b, 0xdda2802c8a800000,
+                0xe0352f62a19e306e, 0xd50b2037ad200000,
+                0x8c213d9da502de45, 0x4526f422cc340000,
+                0xaf298d050e4395d6, 0x9670b12b7f410000,
+                0xdaf3f04651d47b4c, 0x3c0cdd765f114000,
+                0x88d8762bf324cd0f, 0xa5880a69fb6ac800,
+                0xab0e93b6efee0053, 0x8eea0d047a457a00,
+                0xd5d238a4abe98068, 0x72a4904598d6d880,
+                0x85a36366eb71f041, 0x47a6da2b7f864750,
+                0xa70c3c40a64e6c51, 0x999090b65f67d924,
+                0xd0cf4b50cfe20765, 0xfff4b4e3f741cf6d,
+                0x82818f1281ed449f, 0xbff8f10e7a8921a4,
+                0xa321f2d7226895c7, 0xaff72d52192b6a0d,
+                0xcbea6f8ceb02bb39, 0x9bf4f8a69f764490,
+                0xfee50b7025c36a08, 0x02f236d04753d5b4,
+                0x9f4f2726179a2245, 0x01d762422c946590,
+                0xc722f0ef9d80aad6, 0x424d3ad2b7b97ef5,
+                0xf8ebad2b84e0d58b, 0xd2e0898765a7deb2,
+                0x9b934c3b330c8577, 0x63cc55f49f88eb2f,
+                0xc2781f49ffcfa6d5, 0x3cbf6b71c76b25fb,
+                0xf316271c7fc3908a, 0x8bef464e3945ef7a,
+                0x97edd871cfda3a56, 0x97758bf0e3cbb5ac,
+                0xbde94e8e43d0c8ec, 0x3d52eeed1cbea317,
+                0xed63a231d4c4fb27, 0x4ca7aaa863ee4bdd,
+                0x945e455f24fb1cf8, 0x8fe8caa93e74ef6a,
+                0xb975d6b6ee39e436, 0xb3e2fd538e122b44,
+                0xe7d34c64a9c85d44, 0x60dbbca87196b616,
+                0x90e40fbeea1d3a4a, 0xbc8955e946fe31cd,
+                0xb51d13aea4a488dd, 0x6babab6398bdbe41,
+                0xe264589a4dcdab14, 0xc696963c7eed2dd1,
+                0x8d7eb76070a08aec, 0xfc1e1de5cf543ca2,
+                0xb0de65388cc8ada8, 0x3b25a55f43294bcb,
+                0xdd15fe86affad912, 0x49ef0eb713f39ebe,
+                0x8a2dbf142dfcc7ab, 0x6e3569326c784337,
+                0xacb92ed9397bf996, 0x49c2c37f07965404,
+                0xd7e77a8f87daf7fb, 0xdc33745ec97be906,
+                0x86f0ac99b4e8dafd, 0x69a028bb3ded71a3,
+                0xa8acd7c0222311bc, 0xc40832ea0d68ce0c,
+                0xd2d80db02aabd62b, 0xf50a3fa490c30190,
+                0x83c7088e1aab65db, 0x792667c6da79e0fa,
+                0xa4b8cab1a1563f52, 0x577001b891185938,
+                0xcde6fd5e09abcf26, 0xed4c0226b55e6f86,
+                0x80b05e5ac60b6178, 0x544f8158315b05b4,
+                0xa0dc75f1778e39d6, 0x696361ae3db1c721,
+                0xc913936dd571c84c, 0x03bc3a19cd1e38e9,
+                0xfb5878494ace3a5f, 0x04ab48a04065c723,
+                0x9d174b2dcec0e47b, 0x62eb0d64283f9c76,
+                0xc45d1df942711d9a, 0x3ba5d0bd324f8394,
+                0xf5746577930d6500, 0xca8f44ec7ee36479,
+                0x9968bf6abbe85f20, 0x7e998b13cf4e1ecb,
+                0xbfc2ef456ae276e8, 0x9e3fedd8c321a67e,
+                0xefb3ab16c59b14a2, 0xc5cfe94ef3ea101e,
+                0x95d04aee3b80ece5, 0xbba1f1d158724a12,
+                0xbb445da9ca61281f, 0x2a8a6e45ae8edc97,
+                0xea1575143cf97226, 0xf52d09d71a3293bd,
+                0x924d692ca61be758, 0x593c2626705f9c56,
+                0xb6e0c377cfa2e12e, 0x6f8b2fb00c77836c,
+                0xe498f455c38b997a, 0x0b6dfb9c0f956447,
+                0x8edf98b59a373fec, 0x4724bd4189bd5eac,
+                0xb2977ee300c50fe7, 0x58edec91ec2cb657,
+                0xdf3d5e9bc0f653e1, 0x2f2967b66737e3ed,
+                0x8b865b215899f46c, 0xbd79e0d20082ee74,
+                0xae67f1e9aec07187, 0xecd8590680a3aa11,
+                0xda01ee641a708de9, 0xe80e6f4820cc9495,
+                0x884134fe908658b2, 0x3109058d147fdcdd,
+                0xaa51823e34a7eede, 0xbd4b46f0599fd415,
+                0xd4e5e2cdc1d1ea96, 0x6c9e18ac7007c91a,
+                0x850fadc09923329e, 0x03e2cf6bc604ddb0,
+                0xa6539930bf6bff45, 0x84db8346b786151c,
+                0xcfe87f7cef46ff16, 0xe612641865679a63,
+                0x81f14fae158c5f6e, 0x4fcb7e8f3f60c07e,
+                0xa26da3999aef7749, 0xe3be5e330f38f09d,
+                0xcb090c8001ab551c, 0x5cadf5bfd3072cc5,
+                0xfdcb4fa002162a63, 0x73d9732fc7c8f7f6,
+                0x9e9f11c4014dda7e, 0x2867e7fddcdd9afa,
+                0xc646d63501a1511d, 0xb281e1fd541501b8,
+                0xf7d88bc24209a565, 0x1f225a7ca91a4226,
+                0x9ae757596946075f, 0x3375788de9b06958,
+                0xc1a12d2fc3978937, 0x0052d6b1641c83ae,
+                0xf209787bb47d6b84, 0xc0678c5dbd23a49a,
+                0x9745eb4d50ce6332, 0xf840b7ba963646e0,
+                0xbd176620a501fbff, 0xb650e5a93bc3d898,
+                0xec5d3fa8ce427aff, 0xa3e51f138ab4cebe,
+                0x93ba47c980e98cdf, 0xc66f336c36b10137,
+                0xb8a8d9bbe123f017, 0xb80b0047445d4184,
+                0xe6d3102ad96cec1d, 0xa60dc059157491e5,
+                0x9043ea1ac7e41392, 0x87c89837ad68db2f,
+                0xb454e4a179dd1877, 0x29babe4598c311fb,
+                0xe16a1dc9d8545e94, 0xf4296dd6fef3d67a,
+                0x8ce2529e2734bb1d, 0x1899e4a65f58660c,
+                0xb01ae745b101e9e4, 0x5ec05dcff72e7f8f,
+                0xdc21a1171d42645d, 0x76707543f4fa1f73,
+                0x899504ae72497eba, 0x6a06494a791c53a8,
+                0xabfa45da0edbde69, 0x0487db9d17636892,
+                0xd6f8d7509292d603, 0x45a9d2845d3c42b6,
+                0x865b86925b9bc5c2, 0x0b8a2392ba45a9b2,
+                0xa7f26836f282b732, 0x8e6cac7768d7141e,
+                0xd1ef0244af2364ff, 0x3207d795430cd926,
+                0x8335616aed761f1f, 0x7f44e6bd49e807b8,
+                0xa402b9c5a8d3a6e7, 0x5f16206c9c6209a6,
+                0xcd036837130890a1, 0x36dba887c37a8c0f,
+                0x802221226be55a64, 0xc2494954da2c9789,
+                0xa02aa96b06deb0fd, 0xf2db9baa10b7bd6c,
+                0xc83553c5c8965d3d, 0x6f92829494e5acc7,
+                0xfa42a8b73abbf48c, 0xcb772339ba1f17f9,
+                0x9c69a97284b578d7, 0xff2a760414536efb,
+                0xc38413cf25e2d70d, 0xfef5138519684aba,
+                0xf46518c2ef5b8cd1, 0x7eb258665fc25d69,
+                0x98bf2f79d5993802, 0xef2f773ffbd97a61,
+                0xbeeefb584aff8603, 0xaafb550ffacfd8fa,
+                0xeeaaba2e5dbf6784, 0x95ba2a53f983cf38,
+                0x952ab45cfa97a0b2, 0xdd945a747bf26183,
+                0xba756174393d88df, 0x94f971119aeef9e4,
+                0xe912b9d1478ceb17, 0x7a37cd5601aab85d,
+                0x91abb422ccb812ee, 0xac62e055c10ab33a,
+                0xb616a12b7fe617aa, 0x577b986b314d6009,
+                0xe39c49765fdf9d94, 0xed5a7e85fda0b80b,
+                0x8e41ade9fbebc27d, 0x14588f13be847307,
+                0xb1d219647ae6b31c, 0x596eb2d8ae258fc8,
+                0xde469fbd99a05fe3, 0x6fca5f8ed9aef3bb,
+                0x8aec23d680043bee, 0x25de7bb9480d5854,
+                0xada72ccc20054ae9, 0xaf561aa79a10ae6a,
+                0xd910f7ff28069da4, 0x1b2ba1518094da04,
+                0x87aa9aff79042286, 0x90fb44d2f05d0842,
+                0xa99541bf57452b28, 0x353a1607ac744a53,
+                0xd3fa922f2d1675f2, 0x42889b8997915ce8,
+                0x847c9b5d7c2e09b7, 0x69956135febada11,
+                0xa59bc234db398c25, 0x43fab9837e699095,
+                0xcf02b2c21207ef2e, 0x94f967e45e03f4bb,
+                0x8161afb94b44f57d, 0x1d1be0eebac278f5,
+                0xa1ba1ba79e1632dc, 0x6462d92a69731732,
+                0xca28a291859bbf93, 0x7d7b8f7503cfdcfe,
+                0xfcb2cb35e702af78, 0x5cda735244c3d43e,
+                0x9defbf01b061adab, 0x3a0888136afa64a7,
+                0xc56baec21c7a1916, 0x088aaa1845b8fdd0,
+                0xf6c69a72a3989f5b, 0x8aad549e57273d45,
+                0x9a3c2087a63f6399, 0x36ac54e2f678864b,
+                0xc0cb28a98fcf3c7f, 0x84576a1bb416a7dd,
+                0xf0fdf2d3f3c30b9f, 0x656d44a2a11c51d5,
+                0x969eb7c47859e743, 0x9f644ae5a4b1b325,
+                0xbc4665b596706114, 0x873d5d9f0dde1fee,
+                0xeb57ff22fc0c7959, 0xa90cb506d155a7ea,
+                0x9316ff75dd87cbd8, 0x09a7f12442d588f2,
+                0xb7dcbf5354e9bece, 0x0c11ed6d538aeb2f,
+                0xe5d3ef282a242e81, 0x8f1668c8a86da5fa,
+                0x8fa475791a569d10, 0xf96e017d694487bc,
+                0xb38d92d760ec4455, 0x37c981dcc395a9ac,
+                0xe070f78d3927556a, 0x85bbe253f47b1417,
+                0x8c469ab843b89562, 0x93956d7478ccec8e,
+                0xaf58416654a6babb, 0x387ac8d1970027b2,
+                0xdb2e51bfe9d0696a, 0x06997b05fcc0319e,
+                0x88fcf317f22241e2, 0x441fece3bdf81f03,
+                0xab3c2fddeeaad25a, 0xd527e81cad7626c3,
+                0xd60b3bd56a5586f1, 0x8a71e223d8d3b074,
+                0x85c7056562757456, 0xf6872d5667844e49,
+                0xa738c6bebb12d16c, 0xb428f8ac016561db,
+                0xd106f86e69d785c7, 0xe13336d701beba52,
+                0x82a45b450226b39c, 0xecc0024661173473,
+                0xa34d721642b06084, 0x27f002d7f95d0190,
+                0xcc20ce9bd35c78a5, 0x31ec038df7b441f4,
+                0xff290242c83396ce, 0x7e67047175a15271,
+                0x9f79a169bd203e41, 0x0f0062c6e984d386,
+                0xc75809c42c684dd1, 0x52c07b78a3e60868,
+                0xf92e0c3537826145, 0xa7709a56ccdf8a82,
+                0x9bbcc7a142b17ccb, 0x88a66076400bb691,
+                0xc2abf989935ddbfe, 0x6acff893d00ea435,
+                0xf356f7ebf83552fe, 0x0583f6b8c4124d43,
+                0x98165af37b2153de, 0xc3727a337a8b704a,
+                0xbe1bf1b059e9a8d6, 0x744f18c0592e4c5c,
+                0xeda2ee1c7064130c, 0x1162def06f79df73,
+                0x9485d4d1c63e8be7, 0x8addcb5645ac2ba8,
+                0xb9a74a0637ce2ee1, 0x6d953e2bd7173692,
+                0xe8111c87c5c1ba99, 0xc8fa8db6ccdd0437,
+                0x910ab1d4db9914a0, 0x1d9c9892400a22a2,
+                0xb54d5e4a127f59c8, 0x2503beb6d00cab4b,
+                0xe2a0b5dc971f303a, 0x2e44ae64840fd61d,
+                0x8da471a9de737e24, 0x5ceaecfed289e5d2,
+                0xb10d8e1456105dad, 0x7425a83e872c5f47,
+                0xdd50f1996b947518, 0xd12f124e28f77719,
+                0x8a5296ffe33cc92f, 0x82bd6b70d99aaa6f,
+                0xace73cbfdc0bfb7b, 0x636cc64d1001550b,
+                0xd8210befd30efa5a, 0x3c47f7e05401aa4e,
+                0x8714a775e3e95c78, 0x65acfaec34810a71,
+                0xa8d9d1535ce3b396, 0x7f1839a741a14d0d,
+                0xd31045a8341ca07c, 0x1ede48111209a050,
+                0x83ea2b892091e44d, 0x934aed0aab460432,
+                0xa4e4b66b68b65d60, 0xf81da84d5617853f,
+                0xce1de40642e3f4b9, 0x36251260ab9d668e,
+                0x80d2ae83e9ce78f3, 0xc1d72b7c6b426019,
+                0xa1075a24e4421730, 0xb24cf65b8612f81f,
+                0xc94930ae1d529cfc, 0xdee033f26797b627,
+                0xfb9b7cd9a4a7443c, 0x169840ef017da3b1,
+                0x9d412e0806e88aa5, 0x8e1f289560ee864e,
+                0xc491798a08a2ad4e, 0xf1a6f2bab92a27e2,
+                0xf5b5d7ec8acb58a2, 0xae10af696774b1db,
+                0x9991a6f3d6bf1765, 0xacca6da1e0a8ef29,
+                0xbff610b0cc6edd3f, 0x17fd090a58d32af3,
+                0xeff394dcff8a948e, 0xddfc4b4cef07f5b0,
+                0x95f83d0a1fb69cd9, 0x4abdaf101564f98e,
+                0xbb764c4ca7a4440f, 0x9d6d1ad41abe37f1,
+                0xea53df5fd18d5513, 0x84c86189216dc5ed,
+                0x92746b9be2f8552c, 0x32fd3cf5b4e49bb4,
+                0xb7118682dbb66a77, 0x3fbc8c33221dc2a1,
+                0xe4d5e82392a40515, 0x0fabaf3feaa5334a,
+                0x8f05b1163ba6832d, 0x29cb4d87f2a7400e,
+                0xb2c71d5bca9023f8, 0x743e20e9ef511012,
+                0xdf78e4b2bd342cf6, 0x914da9246b255416,
+                0x8bab8eefb6409c1a, 0x1ad089b6c2f7548e,
+                0xae9672aba3d0c320, 0xa184ac2473b529b1,
+                0xda3c0f568cc4f3e8, 0xc9e5d72d90a2741e,
+                0x8865899617fb1871, 0x7e2fa67c7a658892,
+                0xaa7eebfb9df9de8d, 0xddbb901b98feeab7,
+                0xd51ea6fa85785631, 0x552a74227f3ea565,
+                0x8533285c936b35de, 0xd53a88958f87275f,
+                0xa67ff273b8460356, 0x8a892abaf368f137,
+                0xd01fef10a657842c, 0x2d2b7569b0432d85,
+                0x8213f56a67f6b29b, 0x9c3b29620e29fc73,
+                0xa298f2c501f45f42, 0x8349f3ba91b47b8f,
+                0xcb3f2f7642717713, 0x241c70a936219a73,
+                0xfe0efb53d30dd4d7, 0xed238cd383aa0110,
+                0x9ec95d1463e8a506, 0xf4363804324a40aa,
+                0xc67bb4597ce2ce48, 0xb143c6053edcd0d5,
+                0xf81aa16fdc1b81da, 0xdd94b7868e94050a,
+                0x9b10a4e5e9913128, 0xca7cf2b4191c8326,
+                0xc1d4ce1f63f57d72, 0xfd1c2f611f63a3f0,
+                0xf24a01a73cf2dccf, 0xbc633b39673c8cec,
+                0x976e41088617ca01, 0xd5be0503e085d813,
+                0xbd49d14aa79dbc82, 0x4b2d8644d8a74e18,
+                0xec9c459d51852ba2, 0xddf8e7d60ed1219e,
+                0x93e1ab8252f33b45, 0xcabb90e5c942b503,
+                0xb8da1662e7b00a17, 0x3d6a751f3b936243,
+                0xe7109bfba19c0c9d, 0x0cc512670a783ad4,
+                0x906a617d450187e2, 0x27fb2b80668b24c5,
+                0xb484f9dc9641e9da, 0xb1f9f660802dedf6,
+                0xe1a63853bbd26451, 0x5e7873f8a0396973,
+                0x8d07e33455637eb2, 0xdb0b487b6423e1e8,
+                0xb049dc016abc5e5f, 0x91ce1a9a3d2cda62,
+                0xdc5c5301c56b75f7, 0x7641a140cc7810fb,
+                0x89b9b3e11b6329ba, 0xa9e904c87fcb0a9d,
+                0xac2820d9623bf429, 0x546345fa9fbdcd44,
+                0xd732290fbacaf133, 0xa97c177947ad4095,
+                0x867f59a9d4bed6c0, 0x49ed8eabcccc485d,
+                0xa81f301449ee8c70, 0x5c68f256bfff5a74,
+                0xd226fc195c6a2f8c, 0x73832eec6fff3111,
+                0x83585d8fd9c25db7, 0xc831fd53c5ff7eab,
+                0xa42e74f3d032f525, 0xba3e7ca8b77f5e55,
+                0xcd3a1230c43fb26f, 0x28ce1bd2e55f35eb,
+                0x80444b5e7aa7cf85, 0x7980d163cf5b81b3,
+                0xa0555e361951c366, 0xd7e105bcc332621f,
+                0xc86ab5c39fa63440, 0x8dd9472bf3fefaa7,
+                0xfa856334878fc150, 0xb14f98f6f0feb951,
+                0x9c935e00d4b9d8d2, 0x6ed1bf9a569f33d3,
+                0xc3b8358109e84f07, 0x0a862f80ec4700c8,
+                0xf4a642e14c6262c8, 0xcd27bb612758c0fa,
+                0x98e7e9cccfbd7dbd, 0x8038d51cb897789c,
+                0xbf21e44003acdd2c, 0xe0470a63e6bd56c3,
+                0xeeea5d5004981478, 0x1858ccfce06cac74,
+                0x95527a5202df0ccb, 0x0f37801e0c43ebc8,
+                0xbaa718e68396cffd, 0xd30560258f54e6ba,
+                0xe950df20247c83fd, 0x47c6b82ef32a2069,
+                0x91d28b7416cdd27e, 0x4cdc331d57fa5441,
+                0xb6472e511c81471d, 0xe0133fe4adf8e952,
+                0xe3d8f9e563a198e5, 0x58180fddd97723a6,
+                0x8e679c2f5e44ff8f, 0x570f09eaa7ea7648,
+            };
+            uint64_t bits;
+            if(!m || q < -342){
+                bits = 0;
+            } else if(q > 308){
+                bits = (uint64_t)0x7ff << 52;
+            } else {
+                int lz = __builtin_clzll(m);
+                m <<= lz;
+                const uint64_t *pow5 = powers_of_five + 2 * (q + 342);
+                __uint128_t product = (__uint128_t)m * pow5[0];
+                uint64_t high = product >> 64, low = (uint64_t)product;
+                if((high & 0x1ff) == 0x1ff){
+                    // The low bits might carry into the ones that matter, use the rest of 5^q.
+                    uint64_t second = ((__uint128_t)m * pow5[1]) >> 64;
+                    low += second;
+                    if(second > low) high++;
+                }
+                int upperbit = high >> 63, shift = upperbit + 9;
+                uint64_t mantissa = high >> shift;
+                // floor(log2(10^q)) + 63, from a fixed point log2(10).
+                int32_t power2 = (int32_t)(((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+                if(power2 <= 0){
+                    // Subnormal.
+                    if(-power2 + 1 >= 64){
+                        mantissa = 0;
+                        power2 = 0;
+                    } else {
+                        mantissa >>= -power2 + 1;
+                        mantissa += mantissa & 1;
+                        mantissa >>= 1;
+                        power2 = mantissa < (uint64_t)1 << 52 ? 0 : 1;
+                    }
+                } else {
+                    // Exactly halfway between two doubles: round to even instead of up.
+                    if(low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == high){
+                        mantissa &= ~(uint64_t)1;
+                    }
+                    mantissa += mantissa & 1;
+                    mantissa >>= 1;
+                    if(mantissa >= (uint64_t)2 << 52){
+                        mantissa = (uint64_t)1 << 52;
+                        power2++;
+                    }
+                    mantissa &= ~((uint64_t)1 << 52);
+                    if(power2 >= 0x7ff){
+                        mantissa = 0;
+                        power2 = 0x7ff;
+                    }
+                }
+                bits = mantissa | (uint64_t)power2 << 52;
+            }
+            if(negative) bits |= (uint64_t)1 << 63;
+            double d;
+            memcpy(&d, &bits, sizeof d);
+            return d;
+        }
+#endif
+
+        /* Reads the number starting at `curr` (which is a digit or '-').
+         * Returns a pointer directly after it, or nullptr if it's invalid.
+         * Decimals go in `d` (and set `decimal`), integers in `i`. Integers that don't fit in an
+         * int64_t are read as decimals.
+         * The significand is gathered 8 digits at a time. Decimals whose significand and power of
+         * ten are both exactly representable are then one exactly rounded multiplication or
+         * division (Clinger's fast path), almost all others are eisel_lemire(), and the few left
+         * (more than 19 digits, right between two doubles) go to std::from_chars. All of them are
+         * correctly rounded. Nothing past the number is ever read, and the locale doesn't matter.
+         */
+        static const char *read_number(const char *curr, const char *end, bool& decimal, int64_t& i, double& d){
+            const char *p = curr;
+            bool negative = *p == '-';
+            if(negative) p++;
+            if(p == end || !is_digit(*p)) return nullptr;
+            uint64_t m = 0;
+            int digits = 0, dropped = 0;
+            int64_t exp10 = 0;
+            if(*p == '0'){
+                p++;
+                // Non-zero numbers can't start with 0.
+                if(p != end && is_digit(*p)) return nullptr;
+            } else {
+                p = read_digits(p, end, m, digits, dropped);
+                exp10 = dropped;
+            }
+            decimal = false;
+            if(p != end && *p == '.'){
+                decimal = true;
+                p++;
+                if(p == end || !is_digit(*p)) return nullptr;
+                if(!m){
+                    // Leading zeros aren't significant.
+                    const char *zeros = p;
+                    while(p != end && *p == '0') p++;
+                    exp10 -= p - zeros;
+                }
+                int before = digits;
+                p = read_digits(p, end, m, digits, dropped);
+                exp10 -= digits - before;
+            }
+            if(p != end && (*p == 'e' || *p == 'E')){
+                decimal = true;
+                p++;
+                bool negative_exp = false;
+                if(p != end && (*p == '+' || *p == '-')) negative_exp = *p++ == '-';
+                if(p == end || !is_digit(*p)) return nullptr;
+                int64_t e = 0;
+                for(; p != end && is_digit(*p); p++){
+                    if(e < 1000000) e = e * 10 + (*p - '0');
+                }
+                exp10 += negative_exp ? -e : e;
+            }
+            if(!decimal){
+                if(!dropped && m <= (uint64_t)INT64_MAX){
+                    i = negative ? -(int64_t)m : (int64_t)m;
+                    return p;
+                }
+                if(!dropped && negative && m == (uint64_t)INT64_MAX + 1){
+                    i = INT64_MIN;
+                    return p;
+                }
+                // Too big for an int64_t.
+                decimal = true;
+            }
+#if FLT_EVAL_METHOD == 0
+            static const double powers[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+            if(!dropped && m <= (uint64_t)1 << 53 && -22 <= exp10 && exp10 <= 22 + 15){
+                if(exp10 > 22){
+                    // Move zeros into the significand if it stays exact (like 12e30 = 12e8 * 1e22).
+                    for(; exp10 > 22 && m <= ((uint64_t)1 << 53) / 10; exp10--) m *= 10;
+                }
+                if(exp10 <= 22){
+                    d = (double)m;
+                    d = exp10 < 0 ? d / powers[-exp10] : d * powers[exp10];
+                    if(negative) d = -d;
+                    return p;
+                }
+            }
+#endif
+#ifdef __SIZEOF_INT128__
+            if(!dropped){
+                d = eisel_lemire(m, exp10, negative);
+                return p;
+            }
+            // Digits were dropped, so the number is somewhere between m and m + 1 (times 10^exp10).
+            // If both round to the same double, that's it.
+            d = eisel_lemire(m, exp10, negative);
+            if(d == eisel_lemire(m + 1, exp10, negative)) return p;
+#endif
+            auto res = std::from_chars(curr, p, d);
+            if(res.ec == std::errc::result_out_of_range){
+                // m has `digits` digits, so the number is below 10^(digits + exp10).
+                d = digits + exp10 > 0 ? HUGE_VAL : 0.0;
+                if(negative) d = -d;
+            }
+            return p;
+        }
+
+        /* Where the number starting at `curr` ends, or nullptr if it's invalid, by the same rules as
+         * read_number() but without working out its value. `decimal` is what read_number() would say:
+         * there's a fraction or exponent, or it doesn't fit an int64_t. */
+        static const char *skip_number(const char *p, const char *end, bool& decimal){
+            bool negative = *p == '-';
+            if(negative) p++;
+            if(p == end || !is_digit(*p)) return nullptr;
+            decimal = false;
+            if(*p == '0'){
+                p++;
+                if(p != end && is_digit(*p)) return nullptr;
+            } else {
+                const char *digits = p;
+                while(p != end && is_digit(*p)) p++;
+                if(p - digits >= 19){
+                    static constexpr char max[] = "9223372036854775807", min[] = "9223372036854775808";
+                    decimal = p - digits > 19 || memcmp(digits, negative ? min : max, 19) > 0;
+                }
+            }
+            if(p != end && *p == '.'){
+                decimal = true;
+                p++;
+                if(p == end || !is_digit(*p)) return nullptr;
+                while(p != end && is_digit(*p)) p++;
+            }
+            if(p != end && (*p == 'e' || *p == 'E')){
+                decimal = true;
+                p++;
+                if(p != end && (*p == '+' || *p == '-')) p++;
+                if(p == end || !is_digit(*p)) return nullptr;
+                while(p != end && is_digit(*p)) p++;
+            }
+            return p;
+        }
+
+        /* Time to beat RapidJSON. */
+        /* Just to make life easier: */
+#define fail(p) do { \
+    st.error = (p); \
+    return false; \
+} while(0)
+#define next_token() do { \
+    curr = st.index.next(); \
+    if(curr == st.end) fail(st.end); \
+} while(0)
+#define expect(c) do { \
+    if(*curr != c) fail(curr); \
+} while(0)
+#define expect_literal(s, n) do { \
+    if(st.end - curr < n || memcmp(curr, s, n)) fail(curr); \
+    curr += n; \
+} while(0)
+#define emit(event) do { \
+    HEX_JSON_TIME(BUILD); \
+    if(!h.event){ \
+        st.code = STOPPED; \
+        fail(curr); \
+    } \
+} while(0)
+        /* The grammar: parses one value, calling the matching methods of `h` as it goes (see
+         * hex::sax_handler). Every token starts at the next offset of the structural index, so there's
+         * no whitespace to skip.
+         * It's a loop rather than a recursion: the containers it's in are bits in st, and nesting
+         * deeper than st.max_depth fails with TOO_DEEP, so no input can run the stack out.
+         * Returns false if the JSON was invalid or the handler stopped it, with st.error set to where.
+         */
+        template<typename Handler>
+        static bool parse_value(sax_state& st, Handler& h){
+            // JSON types: object, array, std::string, numbers, boolean, null
+            // Current character.
+            const char *curr;
+            size_t depth = 0;
+            // Whether the innermost container is an object (cached from st).
+            bool in_object = false;
+
+        value:
+            next_token();
+
+            /* Object
+             * { "key1": <member1> , "key2": <member2> , ... }
+             */
+            if(*curr == '{'){
+                if(depth == st.max_depth){
+                    st.code = TOO_DEEP;
+                    fail(curr);
+                }
+                st.set_container(depth++, in_object = true);
+                HEX_JSON_STAT(stats->values[OBJECT]++, stats->max_depth = std::max(stats->max_depth, depth));
+                emit(on_start_object());
+                next_token();
+                // Check for empty object.
+                if(*curr == '}'){
+                    emit(on_end_object());
+                    goto end_container;
+                }
+                goto key;
+            }
+
+            /* Array
+             * [ <member1> , <member2> , ... ]
+             */
+            else if(*curr == '['){
+                if(depth == st.max_depth){
+                    st.code = TOO_DEEP;
+                    fail(curr);
+                }
+                st.set_container(depth++, in_object = false);
+                HEX_JSON_STAT(stats->values[ARRAY]++, stats->max_depth = std::max(stats->max_depth, depth));
+                emit(on_start_array());
+                // Check for empty array.
+                const char *peek = st.index.peek();
+                if(peek != st.end && *peek == ']'){
+                    st.index.next();
+                    curr = peek;
+                    emit(on_end_array());
+                    goto end_container;
+                }
+                goto value;
+            }
+
+            /* String
+             * "x"
+             */
+            else if(*curr == '"'){
+                std::string_view str;
+                if(!read_string(st, curr, str)) return false;
+                HEX_JSON_STAT(stats->values[STRING]++);
+                emit(on_string(str));
+                goto value_done;
+            }
+
+            /* Number
+             * 31.415e-1
+             */
+            else if(('0' <= *curr && *curr <= '9') || *curr == '-'){
+                bool decimal;
+                int64_t i;
+                double d;
+                const char *next;
+                if(!st.decode){
+                    next = skip_number(curr, st.end, decimal);
+                    i = 0;
+                    d = 0;
+                } else {
+                    HEX_JSON_TIME(NUMBERS);
+                    next = read_number(curr, st.end, decimal, i, d);
+                }
+                if(!next) fail(curr);
+                curr = next;
+                HEX_JSON_STAT(stats->values[decimal ? DECIMAL : INTEGER]++);
+                if(decimal) emit(on_double(d));
+                else emit(on_int64(i));
+            }
+
+            /* Booleans
+             * true
+             * false
+             */
+            else if(*curr == 't'){
+                expect_literal("true", 4);
+                HEX_JSON_STAT(stats->values[BOOLEAN]++);
+                emit(on_bool(true));
+            } else if(*curr == 'f'){
+                expect_literal("false", 5);
+                HEX_JSON_STAT(stats->values[BOOLEAN]++);
+                emit(on_bool(false));
+            }
+
+            /* Null
+             * null
+             */
+            else if(*curr == 'n'){
+                expect_literal("null", 4);
+                HEX_JSON_STAT(stats->values[UNDEFINED]++);
+                emit(on_null());
+            }
+
+            // Otherwise, it's invalid.
+            else {
+                fail(curr);
+            }
+
+            /* Scalars aren't delimited by the index, so make sure nothing is stuck to the end
+             * of this one (like in `truex` or `12"a"`). */
+            if(curr != st.end && !is_space(*curr) && !is_op(*curr)) fail(curr);
+
+        value_done:
+            // Either that was the whole value, or its container goes on.
+            if(!depth) return true;
+            next_token();
+            if(in_object){
+                if(*curr == '}'){
+                    emit(on_end_object());
+                    goto end_container;
+                }
+                expect(',');
+                next_token();
+                goto key;
+            }
+            if(*curr == ']'){
+                emit(on_end_array());
+                goto end_container;
+            }
+            expect(',');
+            goto value;
+
+        key:
+            // curr is at what should be the next key of an object.
+            {
+                expect('"');
+                std::string_view key;
+                if(!read_string(st, curr, key)) return false;
+                HEX_JSON_STAT(stats->keys++);
+                emit(on_key(key));
+                next_token();
+                expect(':');
+                goto value;
+            }
+
+        end_container:
+            depth--;
+            if(depth) in_object = st.in_object(depth - 1);
+            goto value_done;
+        }
+#undef emit
+#undef expect_literal
+#undef expect
+#undef next_token
+#undef fail
+        /* Parses a whole JSON text, calling the methods of `handler` for every value, key and
+         * container boundary instead of building a tree (see hex::sax_handler).
+         * Strings are only valid during the call, unless `side` is given: then escaped strings are
+         * decoded into memory from it, and the others point into the input.
+         * Returns nullptr if the text was valid, otherwise where it stopped being valid (or where
+         * the handler returned false), and if `why` is given, sets it to the parse_error.
+         */
+        template<typename Handler>
+        static const char *parse_sax(const char *input, const char *end, Handler& handler, std::pmr::memory_resource *side = nullptr,
+                                     size_t max_depth = default_max_depth, parse_error *why = nullptr){
+            HEX_JSON_SESSION(end - input);
+            sax_state st(input, end, side, max_depth);
+            return parse_sax(st, handler, why);
+        }
+        /* The same, with a state that's been reset() to the input, so its buffers can be reused. */
+        template<typename Handler>
+        static const char *parse_sax(sax_state& st, Handler& handler, parse_error *why = nullptr){
+            const char *p;
+            if(parse_value(st, handler)){
+                // Whitespace isn't in the index, so anything left is trailing garbage.
+                p = st.index.peek();
+                if(p == st.end) p = nullptr;
+            } else p = st.error;
+            if(why) *why = !p ? PARSE_OK : st.code ? st.code : SYNTAX_ERROR;
+            return p;
+        }
+
+        /* The handler parse() uses to build a tree, allocating from `mr`.
+         * With `insitu`, strings and long keys are borrowed from the input (see set_view()).
+         * With a key_table, long keys it has (or adds) are borrowed from it instead.
+         */
+        template<bool insitu = false>
+        class dom_builder {
+            json *root;
+            std::pmr::memory_resource *mr;
+            std::vector<json*> stack;
+            json *pending = nullptr;     // value of the last key
+            key_table *keys;
+            /* Where the next value goes. */
+            inline json& slot(){
+                if(stack.empty()) return *root;
+                json *top = stack.back();
+                if(top->type == ARRAY) return top->as_arr().emplace_back(INVALID_ITEM);
+                return *pending;
+            }
+            public:
+            dom_builder(json& root, std::pmr::memory_resource *mr, key_table *keys = nullptr) : root(&root), mr(mr), keys(keys) {}
+            inline void intern_keys(key_table *keys) noexcept {
+                this->keys = keys;
+            }
+            /* Builds the next tree into `root`, keeping the stack's memory. */
+            void reset(json& root){
+                this->root = &root;
+                stack.clear();
+                pending = nullptr;
+            }
+            bool on_start_object(){
+                json& j = slot();
+                j.set_type(OBJECT, mr);
+                stack.push_back(&j);
+                return true;
+            }
+            bool on_key(std::string_view k){
+                // One lookup per member: a duplicate key gets its value overwritten.
+                object o = stack.back()->as_obj();
+                if(keys && k.size() > key::inline_size){
+                    if(const char *interned = keys->get(k)){
+                        pending = &o.try_emplace_view(std::string_view(interned, k.size()), INVALID_ITEM).first->second;
+                        return true;
+                    }
+                }
+                auto member = insitu ? o.try_emplace_view(k, INVALID_ITEM) : o.try_emplace(k, INVALID_ITEM);
+                pending = &member.first->second;
+                return true;
+            }
+            bool on_end_object(){
+                stack.pop_back();
+                return true;
+            }
+            bool on_start_array(){
+                json& j = slot();
+                j.set_type(ARRAY, mr);
+                stack.push_back(&j);
+                return true;
+            }
+            bool on_end_array(){
+                stack.pop_back();
+                return true;
+            }
+            bool on_string(std::string_view s){
+                json& j = slot();
+                if constexpr(insitu){
+                    j.set_view(s, mr);
+                } else {
+                    j.set_string(s, mr);
+                }
+                return true;
+            }
+            bool on_int64(int64_t i){
+                slot() = i;
+                return true;
+            }
+            bool on_double(double d){
+                slot() = d;
+                return true;
+            }
+            bool on_bool(bool b){
+                json& j = slot();
+                j = BOOLEAN;
+                j.val.boolean = b;
+                return true;
+            }
+            bool on_null(){
+                slot() = UNDEFINED;
+                return true;
+            }
+        };
+
+        /* Parses a whole JSON text into `result`, allocating from `mr`.
+         * Only trailing whitespace is allowed after the value. If the text isn't valid, result is
+         * INVALID_ITEM, with where in val.invalid_end and why in error_code().
+         * With `keys`, long keys are stored once in the table instead of in every object.
+         */
+        template<bool insitu = false>
+        static void parse(const char *input, const char *end, json& result, std::pmr::memory_resource *mr,
+                          size_t max_depth = default_max_depth, key_table *keys = nullptr){
+            dom_builder<insitu> builder(result, mr, keys);
+            parse_error why;
+            const char *p = parse_sax(input, end, builder, insitu ? mr : nullptr, max_depth, &why);
+            if(p){
+                result = INVALID_ITEM;
+                result.val.invalid_end = p;
+                result.len = why;
+            }
+        }
+        static json parse(const char *input, const char *end){
+            json result(INVALID_ITEM);
+            parse(input, end, result, std::pmr::get_default_resource());
+            return result;
+        }
+        static json parse(const std::string& input){
+            return parse(input.c_str(), input.c_str() + input.size());
+        }
+        /* Parses a file straight out of a mapped_file, without reading it into a string first.
+         * The file is unmapped again before this returns, so on an invalid result invalid_end
+         * doesn't point anywhere useful (use hex::mapped_document to find out where it went wrong).
+         */
+        static json parse_file(const char *path){
+            mapped_file file(path);
+            return parse(file.begin(), file.end());
+        }
+        static json parse_file(const std::string& path){
+            return parse_file(path.c_str());
+        }
+
+        /* Where every document in a stream of them starts (see parse_many()).
+         * Brackets are matched on the structural index, so the documents themselves aren't parsed:
+         * a document is a scalar, or everything from an opening bracket to its closing bracket.
+         * Anything else outside a document starts one too, which then fails to parse.
+         * `on_start` is called with each start and returns false to stop.
+         */
+        template<typename F>
+        static void split_many(const char *input, const char *end, F&& on_start){
+            structural_index index(input, end);
+            size_t depth = 0;
+            bool in_string = false;
+            for(const char *p = index.next(); p != end; p = index.next()){
+                char c = *p;
+                if(c == '"'){
+                    // Closing quotes are tokens too.
+                    in_string = !in_string;
+                    if(!in_string) continue;
+                }
+                if(!depth && !on_start(p)) return;
+                if(c == '{' || c == '[') depth++;
+                else if((c == '}' || c == ']') && depth) depth--;
+            }
+        }
+
+        /* Parses a buffer holding many documents, separated by whitespace (NDJSON, or just
+         * concatenated), on `pool`.
+         * Documents are split up on the calling thread and parsed in batches of about `batch_size`
+         * bytes by the pool, while the calling thread hands the results to `f(json&)` in input
+         * order. A document that isn't valid is passed as an invalid() json. Only a bounded number
+         * of batches are in flight at once, so memory doesn't grow with the input.
+         * Returns the number of documents.
+         */
+        template<typename F>
+        static size_t parse_many(const char *input, const char *end, F&& f, thread_pool& pool = thread_pool::shared(),
+                                 size_t batch_size = 1 << 18){
+            struct batch {
+                std::vector<const char*> starts;
+                const char *end;
+                std::vector<json> docs;
+                bool done = false;
+            };
+            std::deque<batch> in_flight;
+            std::mutex m;
+            std::condition_variable finished;
+            size_t max_in_flight = 2 * pool.size() + 2, count = 0;
+
+            auto deliver_oldest = [&]{
+                batch& b = in_flight.front();
+                for(;;){
+                    {
+                        std::unique_lock<std::mutex> lock(m);
+                        if(b.done) break;
+                    }
+                    // Help out rather than just wait.
+                    if(pool.run_one()) continue;
+                    std::unique_lock<std::mutex> lock(m);
+                    finished.wait(lock, [&]{ return b.done; });
+                }
+                for(json& j : b.docs) f(j);
+                count += b.docs.size();
+                in_flight.pop_front();
+            };
+            auto submit = [&](std::vector<const char*>& starts, const char *batch_end){
+                if(in_flight.size() == max_in_flight) deliver_oldest();
+                in_flight.emplace_back();
+                batch *b = &in_flight.back();
+                b->starts.swap(starts);
+                b->end = batch_end;
+                pool.submit([b, &m, &finished]{
+                    b->docs.reserve(b->starts.size());
+                    for(size_t i = 0; i < b->starts.size(); i++){
+                        const char *doc_end = i + 1 < b->starts.size() ? b->starts[i + 1] : b->end;
+                        b->docs.emplace_back(INVALID_ITEM);
+                        parse(b->starts[i], doc_end, b->docs.back(), std::pmr::get_default_resource());
+                    }
+                    std::lock_guard<std::mutex> lock(m);
+                    b->done = true;
+                    finished.notify_all();
+                });
+            };
+
+            std::vector<const char*> starts;
+            try {
+                split_many(input, end, [&](const char *p){
+                    if(!starts.empty() && (size_t)(p - starts.front()) >= batch_size) submit(starts, p);
+                    starts.push_back(p);
+                    return true;
+                });
+                if(!starts.empty()) submit(starts, end);
+                while(!in_flight.empty()) deliver_oldest();
+            } catch(...) {
+                // The batches still being parsed point into this frame.
+                std::unique_lock<std::mutex> lock(m);
+                finished.wait(lock, [&]{
+                    return std::all_of(in_flight.begin(), in_flight.end(), [](const batch& b){ return b.done; });
+                });
+                throw;
+            }
+            return count;
+        }
+        template<typename F>
+        static size_t parse_many(const std::string& input, F&& f, thread_pool& pool = thread_pool::shared()){
+            return parse_many(input.c_str(), input.c_str() + input.size(), std::forward<F>(f), pool);
+        }
+        // }}}
+    };
+    static_assert(sizeof(json) == 16, "a json node should be 16 bytes");
+    static_assert(std::is_standard_layout<json>::value && offsetof(json, flags) == json::inline_size,
+                  "inline strings end right before the flags");
+
+    /* Writes JSON text into one growing buffer.
+     * Without a sink the whole text stays in the buffer (see take()). With one, the buffer is handed
+     * to the sink whenever it fills up, and on flush(), which has to be called at the end.
+     * Numbers are written with std::to_chars, so they don't depend on the locale and doubles come out
+     * as the shortest text that reads back as the same double (with a ".0" if it would otherwise
+     * read back as an integer). JSON has no NaN or infinity, so those are written as null.
+     */
+    class serializer {
+        std::string buf;
+        size_t used = 0;
+        sink *out;
+
+        /* Makes room for `n` more bytes and returns where they go. */
+        inline char *reserve(size_t n){
+            if(used + n > buf.size()){
+                if(out && used){
+                    out->write(buf.data(), used);
+                    used = 0;
+                }
+                if(n > buf.size()) buf.resize(std::max(n, buf.size() * 2));
+                else if(!out) buf.resize(std::max(used + n, buf.size() * 2));
+            }
+            return &buf[used];
+        }
+        static inline bool needs_escape(char c){
+            return (unsigned char)c < 0x20 || c == '"' || c == '\\';
+        }
+        /* Returns the first character in [str, end) that has to be escaped (or end). */
+        static const char *find_escape(const char *str, const char *end){
+#ifdef HEX_JSON_X86
+            const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), control = _mm_set1_epi8(0x1f);
+            for(; end - str >= 16; str += 16){
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str));
+                __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                               _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+                int mask = _mm_movemask_epi8(special);
+                if(mask) return str + __builtin_ctz(mask);
+            }
+#endif
+            while(str != end && !needs_escape(*str)) str++;
+            return str;
+        }
+
+        public:
+        explicit serializer(sink *out = nullptr, size_t buffer_size = 1 << 16) : out(out) {
+            buf.resize(std::max<size_t>(buffer_size, 64));
+        }
+        serializer(const serializer&) = delete;
+        serializer& operator=(const serializer&) = delete;
+        inline void put(char c){
+            *reserve(1) = c;
+            used++;
+        }
+        /* Appends bytes as they are. */
+        inline void raw(const char *data, size_t size){
+            if(!size) return;
+            memcpy(reserve(size), data, size);
+            used += size;
+        }
+        inline void raw(std::string_view s){
+            raw(s.data(), s.size());
+        }
+        /* Appends a quoted string, escaping what has to be escaped. */
+        void string(std::string_view s){
+            static const char hex_digits[] = "0123456789abcdef";
+            const char *p = s.data(), *end = p + s.size();
+            put('"');
+            for(;;){
+                const char *special = find_escape(p, end);
+                raw(p, special - p);
+                if(special == end) break;
+                char c = *special, *o = reserve(6);
+                switch(c){
+                    case '"': memcpy(o, "\\\"", 2); used += 2; break;
+                    case '\\': memcpy(o, "\\\\", 2); used += 2; break;
+                    case '\b': memcpy(o, "\\b", 2); used += 2; break;
+                    case '\f': memcpy(o, "\\f", 2); used += 2; break;
+                    case '\n': memcpy(o, "\\n", 2); used += 2; break;
+                    case '\r': memcpy(o, "\\r", 2); used += 2; break;
+                    case '\t': memcpy(o, "\\t", 2); used += 2; break;
+                    default:
+                        memcpy(o, "\\u00", 4);
+                        o[4] = hex_digits[(unsigned char)c >> 4];
+                        o[5] = hex_digits[c & 15];
+                        used += 6;
+                }
+                p = special + 1;
+            }
+            put('"');
+        }
+        void integer(int64_t i){
+            char *o = reserve(20);
+            used = std::to_chars(o, o + 20, i).ptr - buf.data();
+        }
+        void decimal(double d){
+            if(!std::isfinite(d)){
+                raw("null", 4);
+                return;
+            }
+            // The longest shortest representation is 24 characters, plus room for ".0".
+            char *o = reserve(32), *e = std::to_chars(o, o + 32, d).ptr;
+            if(std::find_if(o, e, [](char c){ return c == '.' || c == 'e'; }) == e){
+                memcpy(e, ".0", 2);
+                e += 2;
+            }
+            used = e - buf.data();
+        }
+        void boolean(bool b){
+            if(b) raw("true", 4);
+            else raw("false", 5);
+        }
+        void null(){
+            raw("null", 4);
+        }
+        /* Appends a whole value. */
+        void value(const json& j){
+            val_type type = j.type;
+            if(type == INTEGER) return integer(j.val.integer);
+            if(type == DECIMAL) return decimal(j.val.decimal);
+            if(type == BOOLEAN) return boolean(j.val.boolean);
+            if(type == UNDEFINED) return null();
+            if(type == STRING) return string(j.as_str());
+            if(type == ARRAY){
+                put('[');
+                elements(j, 0, j.len);
+                put(']');
+                return;
+            }
+            if(type == OBJECT){
+                put('{');
+                elements(j, 0, j.len);
+                put('}');
+                return;
+            }
+            /* If it got to this point, it's of type INVALID_ITEM. */
+            dbg << (j.type == INVALID_ITEM ? "INVALID" : "NOT INVALID BUT TRAPPING") << '\n';
+            __builtin_trap();
+        }
+        /* Appends elements [begin, end) of an array, or members of an object, with the commas
+         * that go in front of them. */
+        void elements(const json& j, uint32_t begin, uint32_t end){
+            if(j.type == ARRAY){
+                for(uint32_t i = begin; i < end; i++){
+                    if(i) put(',');
+                    value(j.val.array[i]);
+                }
+                return;
+            }
+            for(uint32_t i = begin; i < end; i++){
+                if(i) put(',');
+                string(j.val.members[i].first.view());
+                put(':');
+                value(j.val.members[i].second);
+            }
+        }
+        /* Hands everything buffered to the sink. */
+        void flush(){
+            if(out && used) out->write(buf.data(), used);
+            used = 0;
+        }
+        /* Without a sink: the text so far, leaving the serializer empty. */
+        std::string take(){
+            buf.resize(used);
+            used = 0;
+            return std::move(buf);
+        }
+    };
+
+    inline std::string json::dump() const {
+        serializer s(nullptr, 256);
+        s.value(*this);
+        return s.take();
+    }
+    inline void json::dump(sink& out) const {
+        serializer s(&out);
+        s.value(*this);
+        s.flush();
+    }
+
+    /* Writes JSON as it's generated, without building a tree first:
+     *   w.begin_object().key("id").value(42).key("tags").begin_array().value("a").end_array().end_object();
+     * Output goes through a serializer, so it's buffered into the sink (or kept, see take()), and
+     * flush() has to be called at the end. raw() takes a value that's already JSON text, as is.
+     * With an indent, every member and element goes on a line of its own; empty containers stay {}
+     * and [].
+     * Commas are worked out from a stack of the open containers. A key or an end with no container
+     * open throws std::logic_error. Built with DEBUG, so does the rest of the misuse (a value without
+     * a key in an object, a key in an array, mismatched ends, a second top-level value); otherwise
+     * that's up to the caller.
+     */
+    class writer {
+        serializer s;
+        static constexpr uint8_t IN_OBJECT = 1, HAS_ITEMS = 2;
+        std::vector<uint8_t> stack;     // per open container
+        bool after_key = false;
+        unsigned indent;
+#ifdef DEBUG
+        bool has_root = false;
+#endif
+        static void misuse(const char *what){
+            throw std::logic_error(std::string("hex::writer: ") + what);
+        }
+
+        void newline(){
+            static const char spaces[] = "                                ";
+            s.put('\n');
+            for(size_t n = stack.size() * indent; n; ){
+                size_t k = std::min(n, sizeof spaces - 1);
+                s.raw(spaces, k);
+                n -= k;
+            }
+        }
+        /* The comma and the line break that go before a value, unless it follows a key. */
+        void before_value(){
+            if(after_key){
+                after_key = false;
+                return;
+            }
+#ifdef DEBUG
+            if(stack.empty() && has_root) misuse("a second value at the top level");
+            if(!stack.empty() && stack.back() & IN_OBJECT) misuse("a value in an object without a key");
+            has_root = true;
+#endif
+            if(stack.empty()) return;
+            if(stack.back() & HAS_ITEMS) s.put(',');
+            stack.back() |= HAS_ITEMS;
+            if(indent) newline();
+        }
+        writer& open(char c, uint8_t flags){
+            before_value();
+            s.put(c);
+            stack.push_back(flags);
+            return *this;
+        }
+        writer& close(char c, [[maybe_unused]] bool object){
+            if(stack.empty()) misuse("an end without a matching begin");
+#ifdef DEBUG
+            if((bool)(stack.back() & IN_OBJECT) != object) misuse("an end without a matching begin");
+            if(after_key) misuse("a key without a value");
+#endif
+            bool items = stack.back() & HAS_ITEMS;
+            stack.pop_back();
+            if(indent && items) newline();
+            s.put(c);
+            return *this;
+        }
+
+        public:
+        /* Writes into `out`, or keeps the text if it's null. An indent of 0 writes compact JSON. */
+        explicit writer(sink *out = nullptr, unsigned indent = 0, size_t buffer_size = 1 << 16)
+            : s(out, buffer_size), indent(indent) {}
+        writer& begin_object(){
+            return open('{', IN_OBJECT);
+        }
+        writer& end_object(){
+            return close('}', true);
+        }
+        writer& begin_array(){
+            return open('[', 0);
+        }
+        writer& end_array(){
+            return close(']', false);
+        }
+        writer& key(std::string_view k){
+            if(stack.empty()) misuse("a key outside an object");
+#ifdef DEBUG
+            if(!(stack.back() & IN_OBJECT)) misuse("a key outside an object");
+            if(after_key) misuse("a key without a value");
+#endif
+            if(stack.back() & HAS_ITEMS) s.put(',');
+            stack.back() |= HAS_ITEMS;
+            if(indent) newline();
+            s.string(k);
+            s.put(':');
+            if(indent) s.put(' ');
+            after_key = true;
+            return *this;
+        }
+        /* Any integer but bool, as an int64_t. */
+        template<typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+        writer& value(T i){
+            before_value();
+            s.integer((int64_t)i);
+            return *this;
+        }
+        writer& value(double d){
+            before_value();
+            s.decimal(d);
+            return *this;
+        }
+        writer& value(bool b){
+            before_value();
+            s.boolean(b);
+            return *this;
+        }
+        writer& value(std::string_view str){
+            before_value();
+            s.string(str);
+            return *this;
+        }
+        writer& value(const char *str){
+            return value(std::string_view(str));
+        }
+        /* A whole tree, indented like the rest. */
+        writer& value(const json& j){
+            if(indent && j.type == ARRAY){
+                begin_array();
+                for(const json& e : j.as_arr()) value(e);
+                return end_array();
+            }
+            if(indent && j.type == OBJECT){
+                begin_object();
+                for(const auto& m : j.as_obj()) key(m.first.view()).value(m.second);
+                return end_object();
+            }
+            before_value();
+            s.value(j);
+            return *this;
+        }
+        writer& null(){
+            before_value();
+            s.null();
+            return *this;
+        }
+        /* A value that's already serialized, written as it is (it isn't checked or re-indented). */
+        writer& raw(std::string_view fragment){
+            before_value();
+            s.raw(fragment);
+            return *this;
+        }
+        /* Open containers. */
+        inline size_t depth() const noexcept {
+            return stack.size();
+        }
+        /* Hands everything buffered to the sink. */
+        void flush(){
+            s.flush();
+        }
+        /* Without a sink: the text so far, leaving the writer empty. */
+        std::string take(){
+            return s.take();
+        }
+    };
+
+    /* Serializes a large tree on a thread pool.
+     * Values estimated to be larger than a chunk are split: runs of their elements (or members)
+     * become tasks that serialize into buffers of their own, and what's between the runs (brackets,
+     * commas, keys of split members) is kept as literal pieces. The pieces, in order, are exactly
+     * the text serializer::value() writes.
+     */
+    class parallel_dump {
+        struct piece {
+            const json *node = nullptr;     // null: only `text`
+            bool whole = false;             // the whole node, not just elements [begin, end)
+            uint32_t begin = 0, end = 0;
+            size_t estimate = 0;
+            std::string text;
+        };
+        std::vector<piece> pieces;
+        size_t chunk;
+
+        /* A guess at the length of the text, without formatting numbers. */
+        static size_t estimate(const json& j) noexcept {
+            if(j.type == ARRAY){
+                size_t n = 2 + j.len;
+                for(const json& e : j.as_arr()) n += estimate(e);
+                return n;
+            }
+            if(j.type == OBJECT){
+                size_t n = 2 + j.len;
+                for(const auto& m : j.as_obj()) n += m.first.size() + 3 + estimate(m.second);
+                return n;
+            }
+            if(j.type == STRING) return j.as_str().size() + 2;
+            if(j.type == DECIMAL) return 18;
+            if(j.type == INTEGER) return 10;
+            return 5;
+        }
+        std::string& literal(){
+            if(pieces.empty() || pieces.back().node) pieces.emplace_back();
+            return pieces.back().text;
+        }
+        void run(const json& j, uint32_t begin, uint32_t end, size_t size){
+            if(begin == end) return;
+            pieces.emplace_back();
+            piece& p = pieces.back();
+            p.node = &j;
+            p.begin = begin;
+            p.end = end;
+            p.estimate = size;
+        }
+        void plan(const json& j, size_t size){
+            if(size <= chunk || !(j.type == ARRAY || j.type == OBJECT)){
+                pieces.emplace_back();
+                pieces.back().node = &j;
+                pieces.back().whole = true;
+                pieces.back().estimate = size;
+                return;
+            }
+            bool array = j.type == ARRAY;
+            literal() += array ? '[' : '{';
+            uint32_t first = 0;
+            size_t sum = 0;
+            for(uint32_t i = 0; i < j.len; i++){
+                const json& e = array ? j.val.array[i] : j.val.members[i].second;
+                size_t n = estimate(e) + 1;
+                if(n <= chunk){
+                    if(!array) n += j.val.members[i].first.size() + 3;
+                    sum += n;
+                    if(sum >= chunk){
+                        run(j, first, i + 1, sum);
+                        first = i + 1;
+                        sum = 0;
+                    }
+                    continue;
+                }
+                run(j, first, i, sum);
+                first = i + 1;
+                sum = 0;
+                serializer s(nullptr, 64);
+                if(i) s.put(',');
+                if(!array){
+                    s.string(j.val.members[i].first.view());
+                    s.put(':');
+                }
+                literal() += s.take();
+                plan(e, n);
+            }
+            run(j, first, j.len, sum);
+            literal() += array ? ']' : '}';
+        }
+        static void serialize(piece& p){
+            serializer s(nullptr, p.estimate + p.estimate / 4 + 64);
+            if(p.whole) s.value(*p.node);
+            else s.elements(*p.node, p.begin, p.end);
+            p.text = s.take();
+        }
+
+        public:
+        /* The smallest chunk worth a task of its own. */
+        static constexpr size_t min_chunk = 1 << 16;
+        parallel_dump(const json& root, thread_pool& pool){
+            size_t size = estimate(root);
+            // Several chunks per thread, so threads that finish early can steal the rest.
+            chunk = std::max(min_chunk, size / (8 * pool.size()));
+            plan(root, size);
+            if(pieces.size() == 1){
+                serialize(pieces[0]);
+                return;
+            }
+            std::mutex m;
+            std::condition_variable finished;
+            size_t left = 0;
+            std::exception_ptr error;
+            auto wait = [&]{
+                for(;;){
+                    {
+                        std::lock_guard<std::mutex> lock(m);
+                        if(!left) return;
+                    }
+                    // Help out rather than just wait.
+                    if(pool.run_one()) continue;
+                    std::unique_lock<std::mutex> lock(m);
+                    finished.wait(lock, [&]{ return left == 0; });
+                }
+            };
+            try {
+                for(piece& p : pieces){
+                    if(!p.node) continue;
+                    {
+                        std::lock_guard<std::mutex> lock(m);
+                        left++;
+                    }
+                    try {
+                        pool.submit([&p, &m, &finished, &left, &error]{
+                            std::exception_ptr e;
+                            try {
+                                serialize(p);
+                            } catch(...){
+                                e = std::current_exception();
+                            }
+                            std::lock_guard<std::mutex> lock(m);
+                            if(e && !error) error = e;
+                            if(--left == 0) finished.notify_all();
+                        });
+                    } catch(...){
+                        std::lock_guard<std::mutex> lock(m);
+                        left--;
+                        throw;
+                    }
+                }
+            } catch(...){
+                // The tasks already submitted point into this frame.
+                wait();
+                throw;
+            }
+            wait();
+            if(error) std::rethrow_exception(error);
+        }
+        /* Joins the pieces with one copy. */
+        std::string take(){
+            size_t size = 0;
+            for(const piece& p : pieces) size += p.text.size();
+            std::string out;
+            out.reserve(size);
+            for(const piece& p : pieces) out += p.text;
+            return out;
+        }
+        void write(sink& out){
+            std::vector<std::string_view> views;
+            views.reserve(pieces.size());
+            for(const piece& p : pieces) views.push_back(p.text);
+            out.writev(views.data(), views.size());
+        }
+    };
+
+    inline std::string json::dump(thread_pool& pool) const {
+        return parallel_dump(*this, pool).take();
+    }
+    inline void json::dump(sink& out, thread_pool& pool) const {
+        parallel_dump(*this, pool).write(out);
+    }
+
+    /* A parsed JSON tree that lives entirely in an arena owned by the document.
+     * Every node, container buffer and string byte is allocated from the arena, so parsing
+     * does no per-node heap allocation and destroying the document frees the whole tree at once
+     * (nodes in it are never destroyed one by one).
+     * The nodes are ordinary `json`s. Members added with operator[] or push_back() and anything
+     * assigned to a node stay in the arena; values constructed straight into a container
+     * (try_emplace(), emplace_back()) should be built with resource(), or they leak when the
+     * document goes away.
+     */
+    class document {
+        std::unique_ptr<arena> mem;
+        json *root_;
+        public:
+        explicit document(size_t initial_size = 4096) : mem(new arena(initial_size)) {
+            root_ = new (mem->allocate(sizeof(json), alignof(json))) json(INVALID_ITEM);
+        }
+        document(document&& rhs) noexcept : mem(std::move(rhs.mem)), root_(rhs.root_) {
+            rhs.root_ = nullptr;
+        }
+        document& operator=(document&& rhs) noexcept {
+            mem = std::move(rhs.mem);
+            root_ = rhs.root_;
+            rhs.root_ = nullptr;
+            return *this;
+        }
+        inline json& root() noexcept {
+            return *root_;
+        }
+        inline bool invalid() const noexcept {
+            return root_->invalid();
+        }
+        inline parse_error error_code() const noexcept {
+            return root_->error_code();
+        }
+        inline std::pmr::memory_resource *resource() noexcept {
+            return mem.get();
+        }
+        /* With `keys`, long keys are shared with other documents parsed with the same table. */
+        static document parse(const char *input, const char *end, key_table *keys = nullptr){
+            // The tree is usually a bit larger than the text, start with a block of about that size.
+            document doc(end - input);
+            json::parse(input, end, doc.root(), doc.resource(), json::default_max_depth, keys);
+            return doc;
+        }
+        static document parse(const std::string& input, key_table *keys = nullptr){
+            return parse(input.c_str(), input.c_str() + input.size(), keys);
+        }
+        /* Like parse(), but STRING values point straight into the input instead of being copied.
+         * Only strings with escapes are decoded, into the arena. The input has to outlive the document.
+         */
+        static document parse_insitu(const char *input, const char *end){
+            document doc(end - input);
+            json::parse<true>(input, end, doc.root(), doc.resource());
+            return doc;
+        }
+        static document parse_insitu(const std::string& input){
+            return parse_insitu(input.c_str(), input.c_str() + input.size());
+        }
+        /* Parses a mapped file into the arena. Nothing points into the file afterwards. */
+        static document parse_file(const char *path){
+            mapped_file file(path);
+            return parse(file.begin(), file.end());
+        }
+    };
+
+    /* A document parsed in-situ out of a file that stays mapped for as long as the document lives,
+     * so strings without escapes point straight into the page cache and the file is never copied.
+     */
+    class mapped_document {
+        mapped_file file_;
+        document doc;
+        public:
+        explicit mapped_document(const char *path)
+            : file_(path), doc(document::parse_insitu(file_.begin(), file_.end())) {}
+        explicit mapped_document(const std::string& path) : mapped_document(path.c_str()) {}
+        inline json& root() noexcept {
+            return doc.root();
+        }
+        inline bool invalid() const noexcept {
+            return doc.invalid();
+        }
+        inline std::pmr::memory_resource *resource() noexcept {
+            return doc.resource();
+        }
+        inline const mapped_file& file() const noexcept {
+            return file_;
+        }
+        /* Where in the file parsing failed, if it's invalid(), and why. */
+        inline size_t error_offset() noexcept {
+            return doc.root().val.invalid_end - file_.begin();
+        }
+        inline parse_error error_code() const noexcept {
+            return doc.error_code();
+        }
+    };
+
+    /* A parser that keeps its memory from one parse to the next, for parsing lots of messages.
+     * The tree is built in an arena like a hex::document's. Its blocks, the structural index, the
+     * builder's stack and the buffer escaped strings are decoded into all stay with the parser, and
+     * parse() drops the previous tree without freeing any of it. Once the parser has seen a message
+     * as large as the ones it gets, parsing one does no heap allocation at all.
+     * The tree returned is only valid until the next parse() or until the parser goes away.
+     * acquire() lends out a parser from a pool kept per thread.
+     */
+    class parser {
+        arena mem;
+        json *root_;
+        json::sax_state st;
+        json::dom_builder<false> builder;
+        const char *input = nullptr;
+
+        /* Parsers given back on this thread. Any more than pool_limit of them are freed. */
+        static constexpr size_t pool_limit = 8;
+        static std::vector<std::unique_ptr<parser>>& pool(){
+            static thread_local std::vector<std::unique_ptr<parser>> parsers;
+            return parsers;
+        }
+        public:
+        explicit parser(size_t initial_size = 4096, size_t max_depth = json::default_max_depth)
+            : mem(initial_size), root_(new (mem.allocate(sizeof(json), alignof(json))) json(INVALID_ITEM)),
+              st(nullptr, nullptr, nullptr, max_depth), builder(*root_, &mem) {}
+        parser(const parser&) = delete;
+        parser& operator=(const parser&) = delete;
+
+        /* Parses [input, end) into a tree that replaces the previous one.
+         * If the text isn't valid, the result is INVALID_ITEM (see error_code() and error_offset()).
+         */
+        const json& parse(const char *input, const char *end){
+            HEX_JSON_SESSION(end - input);
+            mem.reset();
+            root_ = new (mem.allocate(sizeof(json), alignof(json))) json(INVALID_ITEM);
+            st.reset(input, end);
+            builder.reset(*root_);
+            this->input = input;
+            parse_error why;
+            const char *p = json::parse_sax(st, builder, &why);
+            if(p){
+                *root_ = INVALID_ITEM;
+                root_->val.invalid_end = p;
+                root_->len = why;
+            }
+            return *root_;
+        }
+        const json& parse(std::string_view input){
+            return parse(input.data(), input.data() + input.size());
+        }
+        inline const json& root() const noexcept {
+            return *root_;
+        }
+        inline bool invalid() const noexcept {
+            return root_->type == INVALID_ITEM;
+        }
+        inline parse_error error_code() const noexcept {
+            return root_->error_code();
+        }
+        /* Where in the last input parsing failed, if it's invalid(). */
+        inline size_t error_offset() const noexcept {
+            return root_->val.invalid_end - input;
+        }
+        /* Stores long keys in `keys` from now on (or, with nullptr, in the tree again). */
+        inline void intern_keys(key_table *keys) noexcept {
+            builder.intern_keys(keys);
+        }
+        /* Bytes the arena holds on to between parses. */
+        inline size_t capacity() const noexcept {
+            return mem.capacity();
+        }
+
+        /* A parser borrowed from the pool of the thread that took it, which it goes back to when
+         * the lease is destroyed. */
+        class lease {
+            std::unique_ptr<parser> p;
+            public:
+            explicit lease(std::unique_ptr<parser> p) noexcept : p(std::move(p)) {}
+            lease(lease&&) noexcept = default;
+            lease& operator=(lease&&) = delete;
+            ~lease(){
+                std::vector<std::unique_ptr<parser>>& parsers = pool();
+                if(p && parsers.size() < pool_limit) parsers.push_back(std::move(p));
+            }
+            inline parser& operator*() const noexcept {
+                return *p;
+            }
+            inline parser *operator->() const noexcept {
+                return p.get();
+            }
+        };
+        static lease acquire(){
+            std::vector<std::unique_ptr<parser>>& parsers = pool();
+            if(parsers.empty()) return lease(std::make_unique<parser>());
+            lease l(std::move(parsers.back()));
+            parsers.pop_back();
+            return l;
+        }
+    };
+
+    /* Strips the whitespace out of [input, end) into `out`, which needs room for end - input bytes,
+     * and checks that it's one valid JSON text by the same rules as json::parse(), without building
+     * anything. Returns nullptr if it is, otherwise where it stops being valid (what invalid_end
+     * would be), setting `why` if given. `size` is set to the bytes written; if the text isn't
+     * valid, what they are isn't specified.
+     * The grammar runs over the structural index with a handler that ignores everything, and
+     * escaped strings and numbers are checked without being decoded. The index copies what isn't whitespace
+     * outside of strings to `out` as it classifies each 64-byte block, so the input is read once.
+     * The index and the grammar's state are kept per thread: once a thread has seen an input as
+     * large, nothing is allocated.
+     */
+    inline const char *minify(const char *input, const char *end, char *out, size_t *size, parse_error *why = nullptr){
+        static thread_local json::sax_state st(nullptr, nullptr, nullptr);
+        st.decode = false;
+        st.reset(input, end, out);
+        sax_handler ignore;
+        const char *p = json::parse_sax(st, ignore, why);
+        if(size) *size = out ? st.index.minified_end() - out : 0;
+        return p;
+    }
+    /* The same into a string, which is empty if the text isn't valid. */
+    inline const char *minify(const char *input, const char *end, std::string& out, parse_error *why = nullptr){
+        out.resize(end - input);
+        size_t size;
+        const char *p = minify(input, end, out.data(), &size, why);
+        out.resize(p ? 0 : size);
+        return p;
+    }
+    inline const char *minify(const std::string& input, std::string& out, parse_error *why = nullptr){
+        return minify(input.data(), input.data() + input.size(), out, why);
+    }
+    /* Only the checking half of minify(). */
+    inline const char *validate(const char *input, const char *end, parse_error *why = nullptr){
+        return minify(input, end, nullptr, nullptr, why);
+    }
+    inline const char *validate(const std::string& input, parse_error *why = nullptr){
+        return validate(input.data(), input.data() + input.size(), why);
+    }
+
+    /* Snapshots: a json tree saved in a binary form that is read in place, so loading one is just
+     * mapping the file. The layout follows the json node, with offsets from the start of the
+     * snapshot instead of pointers:
+     *   header: "hexsnap" and a version byte, 0x01020304 (snapshots are in host byte order),
+     *           4 bytes of padding, the total size (uint64_t), then the root node.
+     *   node: 16 bytes, 8-byte aligned. Bytes 0..8 hold the integer, the double, the boolean or
+     *         the offset of the payload, 8..12 the length, 14 the flags and 15 the val_type.
+     *         Strings of up to 14 bytes are inline, as in json.
+     *   ARRAY payload: the element nodes.
+     *   OBJECT payload: (key node, value node) pairs in insertion order. Objects with more than
+     *         basic_object::linear_limit members are followed by the positions of their members
+     *         sorted by key (uint32_t), for binary search.
+     *   long STRING payload: the bytes.
+     */
+    class snapshot_value;
+    class snapshot {
+        mapped_file file_;
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+
+        static constexpr char magic[8] = {'h', 'e', 'x', 's', 'n', 'a', 'p', 1};
+        static constexpr uint32_t byte_order = 0x01020304;
+        static constexpr size_t root_offset = 24;
+
+        class encoder {
+            std::string out;
+            /* Room for `n` bytes at the end, 8-byte aligned. */
+            size_t reserve(size_t n){
+                size_t at = (out.size() + 7) & ~(size_t)7;
+                out.resize(at + n);
+                return at;
+            }
+            void node(size_t at, uint64_t word, uint32_t len, val_type type){
+                memcpy(&out[at], &word, 8);
+                memcpy(&out[at + 8], &len, 4);
+                out[at + 15] = type;
+            }
+            void string(size_t at, std::string_view s){
+                if(s.size() <= json::inline_size){
+                    memcpy(&out[at], s.data(), s.size());
+                    out[at + 14] = json::INLINE | s.size() << 4;
+                    out[at + 15] = STRING;
+                    return;
+                }
+                size_t p = out.size();
+                out.append(s);
+                node(at, p, s.size(), STRING);
+            }
+            void value(size_t at, const json& j){
+                if(j.type == ARRAY){
+                    size_t p = reserve(16 * (size_t)j.len);
+                    node(at, p, j.len, ARRAY);
+                    for(uint32_t i = 0; i < j.len; i++) value(p + 16 * i, j.val.array[i]);
+                } else if(j.type == OBJECT){
+                    bool indexed = j.len > object::linear_limit;
+                    size_t p = reserve((size_t)j.len * (indexed ? 36 : 32));
+                    node(at, p, j.len, OBJECT);
+                    for(uint32_t i = 0; i < j.len; i++){
+                        string(p + 32 * i, j.val.members[i].first.view());
+                        value(p + 32 * i + 16, j.val.members[i].second);
+                    }
+                    if(indexed){
+                        std::vector<uint32_t> order(j.len);
+                        for(uint32_t i = 0; i < j.len; i++) order[i] = i;
+                        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){
+                            return j.val.members[a].first.view() < j.val.members[b].first.view();
+                        });
+                        memcpy(&out[p + 32 * (size_t)j.len], order.data(), 4 * order.size());
+                    }
+                } else if(j.type == STRING){
+                    string(at, j.as_str());
+                } else if(j.type == INTEGER || j.type == DECIMAL){
+                    node(at, j.val.integer, 0, j.type);
+                } else if(j.type == BOOLEAN){
+                    node(at, j.val.boolean, 0, BOOLEAN);
+                } else if(j.type == UNDEFINED){
+                    node(at, 0, 0, UNDEFINED);
+                } else {
+                    throw std::invalid_argument("hex::snapshot: can't save an invalid value");
+                }
+            }
+            public:
+            std::string encode(const json& root){
+                out.assign(root_offset + 16, '\0');
+                memcpy(&out[0], magic, 8);
+                memcpy(&out[8], &byte_order, 4);
+                value(root_offset, root);
+                uint64_t size = out.size();
+                memcpy(&out[16], &size, 8);
+                return std::move(out);
+            }
+        };
+
+        void open(const char *data, size_t size) noexcept {
+            uint32_t order;
+            uint64_t recorded;
+            if(size < root_offset + 16 || (uintptr_t)data % 8 || memcmp(data, magic, 8)) return;
+            memcpy(&order, data + 8, 4);
+            memcpy(&recorded, data + 16, 8);
+            if(order != byte_order || recorded != size) return;
+            data_ = data;
+            size_ = size;
+        }
+
+        public:
+        /* Maps a snapshot file. Throws std::system_error if it can't be opened; a file that isn't
+         * a snapshot (or was saved on a machine with another byte order) gives an invalid() one.
+         * Only the header is checked: snapshots are trusted caches written by save_snapshot().
+         */
+        explicit snapshot(const char *path) : file_(path) {
+            open(file_.data(), file_.size());
+        }
+        explicit snapshot(const std::string& path) : snapshot(path.c_str()) {}
+        /* A snapshot already in memory, which has to stay there. */
+        snapshot(const char *data, size_t size){
+            open(data, size);
+        }
+        snapshot(const snapshot&) = delete;
+        snapshot& operator=(const snapshot&) = delete;
+        inline bool invalid() const noexcept {
+            return !data_;
+        }
+        inline size_t size() const noexcept {
+            return size_;
+        }
+        inline snapshot_value root() const noexcept;
+        /* The snapshot of a tree, as bytes. Throws std::invalid_argument if it has an invalid node. */
+        static std::string encode(const json& root){
+            return encoder().encode(root);
+        }
+    };
+
+    /* A value in a snapshot: where its node is. Lookups work like lazy_value's: anything missing
+     * gives an invalid() value, so they can be chained. Strings point into the snapshot.
+     */
+    class snapshot_value {
+        friend class snapshot;
+        const char *base = nullptr;     // the start of the snapshot
+        const char *node = nullptr;     // null: invalid
+        snapshot_value(const char *base, const char *node) : base(base), node(node) {}
+
+        inline uint64_t word() const noexcept {
+            uint64_t w;
+            memcpy(&w, node, 8);
+            return w;
+        }
+        inline uint32_t len() const noexcept {
+            uint32_t n;
+            memcpy(&n, node + 8, 4);
+            return n;
+        }
+        inline const char *payload() const noexcept {
+            return base + word();
+        }
+        static inline std::string_view string(const char *base, const char *node) noexcept {
+            uint8_t flags = node[14];
+            if(flags & json::INLINE) return std::string_view(node, flags >> 4);
+            uint64_t offset;
+            uint32_t n;
+            memcpy(&offset, node, 8);
+            memcpy(&n, node + 8, 4);
+            return std::string_view(base + offset, n);
+        }
+        inline snapshot_value member(uint32_t i) const noexcept {
+            return snapshot_value(base, payload() + 32 * (size_t)i + 16);
+        }
+        inline std::string_view key(uint32_t i) const noexcept {
+            return string(base, payload() + 32 * (size_t)i);
+        }
+
+        public:
+        snapshot_value() = default;
+        inline bool invalid() const noexcept {
+            return !node;
+        }
+        inline val_type type() const noexcept {
+            return node ? (val_type)node[15] : INVALID_ITEM;
+        }
+        /* Number of members, elements or bytes of a string (0 for anything else). */
+        size_t size() const noexcept {
+            val_type t = type();
+            if(t == OBJECT || t == ARRAY) return len();
+            if(t == STRING) return string(base, node).size();
+            return 0;
+        }
+        /* Calls f(key, value) for every member, until it returns false. */
+        template<typename F>
+        void for_each_member(F&& f) const {
+            if(type() != OBJECT) return;
+            for(uint32_t i = 0, n = len(); i < n; i++){
+                if(!f(key(i), member(i))) return;
+            }
+        }
+        /* Calls f(value) for every element, until it returns false. */
+        template<typename F>
+        void for_each_element(F&& f) const {
+            if(type() != ARRAY) return;
+            for(uint32_t i = 0, n = len(); i < n; i++){
+                if(!f(snapshot_value(base, payload() + 16 * (size_t)i))) return;
+            }
+        }
+        snapshot_value operator[](std::string_view k) const noexcept {
+            if(type() != OBJECT) return snapshot_value();
+            uint32_t n = len();
+            if(n <= object::linear_limit){
+                for(uint32_t i = 0; i < n; i++){
+                    if(key(i) == k) return member(i);
+                }
+                return snapshot_value();
+            }
+            const char *order = payload() + 32 * (size_t)n;
+            uint32_t lo = 0, hi = n;
+            while(lo < hi){
+                uint32_t mid = lo + (hi - lo) / 2, pos;
+                memcpy(&pos, order + 4 * (size_t)mid, 4);
+                int c = key(pos).compare(k);
+                if(c == 0) return member(pos);
+                if(c < 0) lo = mid + 1;
+                else hi = mid;
+            }
+            return snapshot_value();
+        }
+        snapshot_value operator[](size_t idx) const noexcept {
+            if(type() != ARRAY || idx >= len()) return snapshot_value();
+            return snapshot_value(base, payload() + 16 * idx);
+        }
+        /* Scalar getters: each returns false (leaving `out` alone) if the value isn't of that type.
+         * Integers are accepted as doubles. */
+        bool get(int64_t& out) const noexcept {
+            if(type() != INTEGER) return false;
+            out = word();
+            return true;
+        }
+        bool get(double& out) const noexcept {
+            if(type() == INTEGER) out = (double)(int64_t)word();
+            else if(type() == DECIMAL){
+                uint64_t w = word();
+                memcpy(&out, &w, 8);
+            }
+            else return false;
+            return true;
+        }
+        bool get(bool& out) const noexcept {
+            if(type() != BOOLEAN) return false;
+            out = word() != 0;
+            return true;
+        }
+        bool get(std::string_view& out) const noexcept {
+            if(type() != STRING) return false;
+            out = string(base, node);
+            return true;
+        }
+        inline bool is_null() const noexcept {
+            return type() == UNDEFINED;
+        }
+        /* The getters above, with 0/false/"" for anything that isn't that type. */
+        int64_t as_int() const noexcept {
+            int64_t i = 0;
+            get(i);
+            return i;
+        }
+        double as_double() const noexcept {
+            double d = 0;
+            get(d);
+            return d;
+        }
+        bool as_bool() const noexcept {
+            bool b = false;
+            get(b);
+            return b;
+        }
+        std::string_view as_str() const noexcept {
+            std::string_view s;
+            get(s);
+            return s;
+        }
+        /* Copies this value into a tree. */
+        json to_json() const {
+            val_type t = type();
+            json j(INVALID_ITEM);
+            if(t == OBJECT){
+                j.set_type(OBJECT, std::pmr::get_default_resource());
+                object o = j.as_obj();
+                o.reserve(len());
+                for(uint32_t i = 0, n = len(); i < n; i++) o.try_emplace(key(i), member(i).to_json());
+            } else if(t == ARRAY){
+                j.set_type(ARRAY, std::pmr::get_default_resource());
+                array_t a = j.as_arr();
+                a.reserve(len());
+                for_each_element([&](snapshot_value e){
+                    a.emplace_back(e.to_json());
+                    return true;
+                });
+            } else if(t == STRING){
+                j.set_string(string(base, node), std::pmr::get_default_resource());
+            } else if(t == INTEGER){
+                j = (int64_t)word();
+            } else if(t == DECIMAL){
+                j = as_double();
+            } else if(t == BOOLEAN){
+                j = BOOLEAN;
+                j.val.boolean = word() != 0;
+            } else if(t == UNDEFINED){
+                j = UNDEFINED;
+            }
+            return j;
+        }
+        /* Writes this value as JSON text, the same text the tree would give. */
+        void write(serializer& s) const {
+            val_type t = type();
+            if(t == INTEGER) return s.integer(word());
+            if(t == DECIMAL) return s.decimal(as_double());
+            if(t == BOOLEAN) return s.boolean(word() != 0);
+            if(t == UNDEFINED) return s.null();
+            if(t == STRING) return s.string(string(base, node));
+            if(t == ARRAY){
+                s.put('[');
+                for(uint32_t i = 0, n = len(); i < n; i++){
+                    if(i) s.put(',');
+                    snapshot_value(base, payload() + 16 * (size_t)i).write(s);
+                }
+                s.put(']');
+                return;
+            }
+            if(t == OBJECT){
+                s.put('{');
+                for(uint32_t i = 0, n = len(); i < n; i++){
+                    if(i) s.put(',');
+                    s.string(key(i));
+                    s.put(':');
+                    member(i).write(s);
+                }
+                s.put('}');
+                return;
+            }
+            throw std::invalid_argument("hex::snapshot_value: invalid value");
+        }
+        std::string dump() const {
+            serializer s(nullptr, 256);
+            write(s);
+            return s.take();
+        }
+        void dump(sink& out) const {
+            serializer s(&out);
+            write(s);
+            s.flush();
+        }
+    };
+
+    inline snapshot_value snapshot::root() const noexcept {
+        return data_ ? snapshot_value(data_, data_ + root_offset) : snapshot_value();
+    }
+
+    /* Saves the snapshot of a tree to a file. It's written next to it first and then renamed
+     * over it, so a process mapping `path` never sees half a snapshot.
+     * Throws std::system_error if writing fails, std::invalid_argument for an invalid node.
+     */
+    inline void save_snapshot(const json& root, const std::string& path){
+        std::string bytes = snapshot::encode(root), tmp = path + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        if(!f) throw std::system_error(errno, std::generic_category(), tmp);
+        bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+        int err = errno;
+        if(fclose(f) != 0 && ok){
+            ok = false;
+            err = errno;
+        }
+        if(ok && std::rename(tmp.c_str(), path.c_str()) != 0){
+            ok = false;
+            err = errno;
+        }
+        if(!ok){
+            std::remove(tmp.c_str());
+            throw std::system_error(err, std::generic_category(), path);
+        }
+    }
+
+    class lazy_document;
+    /* A value in a lazy_document: just where it starts in the input.
+     * Nothing is parsed until it's asked for. Looking up a member or an element walks the container
+     * and skips the values it passes over by matching brackets, without building or allocating
+     * anything, so untouched subtrees cost one quick scan.
+     * What gets read is validated (the container syntax walked over, and the scalars returned);
+     * skipped subtrees only have their brackets and strings matched. to_json() validates fully.
+     * A missing member, an out-of-range index or malformed input give an invalid() value, so
+     * lookups can be chained: doc.root()["a"]["b"][2].as_int().
+     */
+    class lazy_value {
+        friend class lazy_document;
+        const char *p = nullptr;
+        lazy_document *doc = nullptr;
+        lazy_value(const char *p, lazy_document *doc) : p(p), doc(doc) {}
+
+        inline const char *input_end() const noexcept;
+        static inline const char *skip_space(const char *p, const char *end){
+            while(p != end && json::is_space(*p)) p++;
+            return p;
+        }
+        /* p is just after an opening quote. Returns one past the closing quote, or nullptr. */
+        static const char *skip_string(const char *p, const char *end){
+            for(;;){
+#ifdef HEX_JSON_X86
+                const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\');
+                while(end - p >= 16){
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                    int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)));
+                    if(mask){
+                        p += __builtin_ctz(mask);
+                        break;
+                    }
+                    p += 16;
+                }
+#endif
+                while(p != end && *p != '"' && *p != '\\') p++;
+                if(p == end) return nullptr;
+                if(*p == '"') return p + 1;
+                // Skip the backslash and whatever it escapes.
+                if(end - p < 2) return nullptr;
+                p += 2;
+            }
+        }
+        /* Returns one past the end of the value starting at p, or nullptr if it never ends. */
+        static const char *skip_value(const char *p, const char *end){
+            if(*p == '"') return skip_string(p + 1, end);
+            if(*p != '{' && *p != '['){
+                while(p != end && !json::is_space(*p) && !json::is_op(*p) && *p != '"') p++;
+                return p;
+            }
+            size_t depth = 0;
+            while(p != end){
+#ifdef HEX_JSON_X86
+                // Only quotes and brackets matter: { and [ are 0x7b and 0x5b, } and ] are 0x7d and 0x5d.
+                const __m128i quote = _mm_set1_epi8('"'), fold = _mm_set1_epi8(0x20),
+                              open = _mm_set1_epi8('{'), close = _mm_set1_epi8('}');
+                while(end - p >= 16){
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                    __m128i folded = _mm_or_si128(v, fold);
+                    int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                   _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close))));
+                    if(mask){
+                        p += __builtin_ctz(mask);
+                        break;
+                    }
+                    p += 16;
+                }
+                if(p == end) break;
+#endif
+                char c = *p;
+                if(c == '"'){
+                    p = skip_string(p + 1, end);
+                    if(!p) return nullptr;
+                    continue;
+                }
+                if(c == '{' || c == '[') depth++;
+                else if(c == '}' || c == ']'){
+                    if(--depth == 0) return p + 1;
+                }
+                p++;
+            }
+            return nullptr;
+        }
+        static inline bool starts_value(char c){
+            return c != ',' && c != ':' && c != '}' && c != ']';
+        }
+        static inline bool ends_scalar(const char *p, const char *end){
+            return p == end || json::is_space(*p) || json::is_op(*p);
+        }
+        /* Whether the raw (still escaped) key [b, e) decodes to `key`. */
+        static bool key_equals(const char *b, const char *e, std::string_view key){
+            const char *special = json::find_special(b, e);
+            if(special == e) return std::string_view(b, e - b) == key;
+            std::string decoded(b, special);
+            if(json::decode_string(special, e + 1, e + 1 - b, decoded) != e + 1) return false;
+            return decoded == key;
         }
-        const json& operator=(int rhs){
-            clean_type();
-            type = INTEGER;
-            val.integer = rhs;
-            return *this;
+
+        public:
+        lazy_value() = default;
+        inline bool invalid() const noexcept {
+            return !p;
         }
-        const json& operator=(int64_t rhs){
-            clean_type();
-            type = INTEGER;
-            val.integer = rhs;
-            return *this;
+        /* The type of the value, found from its first bytes. */
+        val_type type() const {
+            if(!p) return INVALID_ITEM;
+            switch(*p){
+                case '{': return OBJECT;
+                case '[': return ARRAY;
+                case '"': return STRING;
+                case 't': case 'f': return BOOLEAN;
+                case 'n': return UNDEFINED;
+            }
+            if(*p != '-' && (*p < '0' || *p > '9')) return INVALID_ITEM;
+            const char *end = input_end();
+            for(const char *q = p; !ends_scalar(q, end); q++){
+                if(*q == '.' || *q == 'e' || *q == 'E') return DECIMAL;
+            }
+            return INTEGER;
         }
-        const json& operator=(double rhs){
-            clean_type();
-            type = DECIMAL;
-            val.decimal = rhs;
-            return *this;
+        /* Calls f(key, value) for every member, until it returns false.
+         * Returns false if this isn't an object, or its syntax is invalid up to where it stopped. */
+        template<typename F>
+        bool for_each_member(F&& f) const {
+            if(!p || *p != '{') return false;
+            const char *end = input_end(), *q = skip_space(p + 1, end);
+            if(q != end && *q == '}') return true;
+            for(;;){
+                if(q == end || *q != '"') return false;
+                const char *key = q + 1;
+                q = skip_string(key, end);
+                if(!q) return false;
+                const char *key_end = q - 1;
+                q = skip_space(q, end);
+                if(q == end || *q != ':') return false;
+                q = skip_space(q + 1, end);
+                if(q == end || !starts_value(*q)) return false;
+                if(!f(std::string_view(key, key_end - key), lazy_value(q, doc))) return true;
+                q = skip_value(q, end);
+                if(!q) return false;
+                q = skip_space(q, end);
+                if(q == end) return false;
+                if(*q == '}') return true;
+                if(*q != ',') return false;
+                q = skip_space(q + 1, end);
+            }
         }
-        const json& operator=(const char* rhs){
-            std::string s(rhs);
-            operator=(s);
-            return *this;
+        /* Calls f(value) for every element, until it returns false. Same return value as above. */
+        template<typename F>
+        bool for_each_element(F&& f) const {
+            if(!p || *p != '[') return false;
+            const char *end = input_end(), *q = skip_space(p + 1, end);
+            if(q != end && *q == ']') return true;
+            for(;;){
+                if(q == end || !starts_value(*q)) return false;
+                if(!f(lazy_value(q, doc))) return true;
+                q = skip_value(q, end);
+                if(!q) return false;
+                q = skip_space(q, end);
+                if(q == end) return false;
+                if(*q == ']') return true;
+                if(*q != ',') return false;
+                q = skip_space(q + 1, end);
+            }
         }
-        const json& operator=(const array_t& rhs){
-            clean_type();
-            type = ARRAY;
-            val.array = new array_t(rhs);
-            return *this;
+        /* The member called `key` (the last one, if there are duplicates, like parse()). Keys are
+         * passed to for_each_member() still escaped, so this compares them decoded. */
+        lazy_value operator[](std::string_view key) const {
+            lazy_value found;
+            bool ok = for_each_member([&](std::string_view k, lazy_value v){
+                if(key_equals(k.data(), k.data() + k.size(), key)) found = v;
+                return true;
+            });
+            return ok ? found : lazy_value();
         }
-        bool operator==(const json& rhs) const noexcept { 
-            return type == rhs.type &&
-                (type == OBJECT ? *val.object == *rhs.val.object :
-                 type == ARRAY ? *val.array == *rhs.val.array :
-                 type == STRING ? *val.str == *rhs.val.str :
-                 type == BOOLEAN ? val.boolean == rhs.val.boolean :
-                 type == UNDEFINED ? true :
-                 /* all other types are 64 bit */ val.integer == rhs.val.integer);
+        /* The first member called `key`, without looking at the rest of the object. */
+        lazy_value find_first(std::string_view key) const {
+            lazy_value found;
+            for_each_member([&](std::string_view k, lazy_value v){
+                if(!key_equals(k.data(), k.data() + k.size(), key)) return true;
+                found = v;
+                return false;
+            });
+            return found;
         }
-        inline bool operator!=(const json& rhs) const noexcept {
-            return !operator==(rhs);
+        lazy_value operator[](size_t idx) const {
+            lazy_value found;
+            for_each_element([&](lazy_value v){
+                if(idx--) return true;
+                found = v;
+                return false;
+            });
+            return found;
         }
-        json& operator[](const std::string& key){
-            std::string k(key.begin(), key.end());
-            return val.object->operator[](k);
+        /* Number of members or elements (0 if it's neither, or invalid). */
+        size_t size() const {
+            if(!p) return 0;
+            size_t n = 0;
+            bool ok = *p == '{' ? for_each_member([&](std::string_view, lazy_value){ n++; return true; })
+                                : for_each_element([&](lazy_value){ n++; return true; });
+            return ok ? n : 0;
         }
-        json& operator[](size_t idx){
-            return (*val.array)[idx];
+        /* Scalar getters: each returns false (leaving `out` alone) if the value isn't of that type
+         * or isn't valid. Integers are accepted as doubles. */
+        bool get(int64_t& out) const {
+            if(!p) return false;
+            bool decimal;
+            int64_t i;
+            double d;
+            const char *end = input_end(), *next = json::read_number(p, end, decimal, i, d);
+            if(!next || decimal || !ends_scalar(next, end)) return false;
+            out = i;
+            return true;
         }
-        // }}}
-        // convenience functions
-        // {{{
-        inline bool& as_bool() noexcept {
-            return val.boolean;
+        bool get(double& out) const {
+            if(!p) return false;
+            bool decimal;
+            int64_t i;
+            double d;
+            const char *end = input_end(), *next = json::read_number(p, end, decimal, i, d);
+            if(!next || !ends_scalar(next, end)) return false;
+            out = decimal ? d : (double)i;
+            return true;
         }
-        inline int64_t& as_int() noexcept {
-            return val.integer;
+        bool get(bool& out) const {
+            if(!p) return false;
+            const char *end = input_end();
+            if(end - p >= 4 && !memcmp(p, "true", 4) && ends_scalar(p + 4, end)){
+                out = true;
+                return true;
+            }
+            if(end - p >= 5 && !memcmp(p, "false", 5) && ends_scalar(p + 5, end)){
+                out = false;
+                return true;
+            }
+            return false;
         }
-        inline std::string& as_str(){
-            return *val.str;
+        /* Strings without escapes point into the input, others are decoded into the document. */
+        bool get(std::string_view& out) const;
+        bool is_null() const {
+            if(!p) return false;
+            const char *end = input_end();
+            return end - p >= 4 && !memcmp(p, "null", 4) && ends_scalar(p + 4, end);
         }
-        inline double& as_double(){
-            return val.decimal;
+        /* The getters above, with 0/false/"" for anything that isn't that type. */
+        int64_t as_int() const {
+            int64_t i = 0;
+            get(i);
+            return i;
         }
-        void push_back(const json& j){
-            val.array->push_back(j);
+        double as_double() const {
+            double d = 0;
+            get(d);
+            return d;
         }
-        void pop_back(){
-            val.array->pop_back();
+        bool as_bool() const {
+            bool b = false;
+            get(b);
+            return b;
         }
-        inline bool invalid(){
-            return type == INVALID_ITEM;
+        std::string_view as_str() const {
+            std::string_view s;
+            get(s);
+            return s;
         }
-        inline const size_t size() const noexcept {
-            return (type == OBJECT ? val.object->size() :
-                    type == ARRAY ? val.array->size() :
-                    /* type == STRING */ val.str->size());
+        /* Parses (and fully validates) this value into a tree. */
+        json to_json() const {
+            if(!p) return json(INVALID_ITEM);
+            const char *end = skip_value(p, input_end());
+            if(!end) return json(INVALID_ITEM);
+            return json::parse(p, end);
         }
-        inline json& back() noexcept {
-            return val.array->back();
+    };
+
+    /* The entry point of on-demand parsing: `input` isn't looked at until root() and the lazy_values
+     * it leads to are used. The input has to outlive the document, and the document its values.
+     */
+    class lazy_document {
+        friend class lazy_value;
+        const char *input, *end;
+        arena decoded;      // strings with escapes, decoded as they're read
+        public:
+        lazy_document(const char *input, const char *end) : input(input), end(end), decoded(256) {}
+        explicit lazy_document(const std::string& input) : lazy_document(input.data(), input.data() + input.size()) {}
+        explicit lazy_document(const mapped_file& file) : lazy_document(file.begin(), file.end()) {}
+        lazy_document(const lazy_document&) = delete;
+        lazy_document& operator=(const lazy_document&) = delete;
+        lazy_value root(){
+            const char *p = lazy_value::skip_space(input, end);
+            return p == end ? lazy_value() : lazy_value(p, this);
         }
-        inline array_t& as_arr() noexcept {
-            return *val.array;
+    };
+
+    inline const char *lazy_value::input_end() const noexcept {
+        return doc->end;
+    }
+    inline bool lazy_value::get(std::string_view& out) const {
+        if(!p || *p != '"') return false;
+        const char *end = input_end(), *after = skip_string(p + 1, end);
+        if(!after) return false;
+        bool ascii;
+        const char *close = after - 1, *special = json::find_special(p + 1, close, ascii);
+        if((!ascii || special != close) && json::find_invalid_utf8(p + 1, close) != close) return false;
+        if(special == close){
+            out = std::string_view(p + 1, close - p - 1);
+            return true;
         }
-        inline table& as_obj() noexcept {
-            return *val.object;
+        // Decoding never makes a string longer.
+        char *buf = static_cast<char*>(doc->decoded.allocate(close - p, 1));
+        json::char_sink sink = {buf};
+        sink.append(p + 1, special);
+        if(json::decode_string(special, after, after - p, sink) != after) return false;
+        out = std::string_view(buf, sink.p - buf);
+        return true;
+    }
+
+    /* A compiled query for values inside a document.
+     * Either a JSON Pointer (RFC 6901), like "/events/0/price" (with ~0 for ~ and ~1 for /), or the
+     * same thing dotted, like "events.0.price". In both, a segment that's just * matches every
+     * member or element. A segment that's a number without leading zeros also matches that index of
+     * an array. Only the empty string points at the whole document.
+     * Segments are split and unescaped once, so evaluating a path doesn't allocate. It can run over a
+     * tree, or over raw input, where only the matches are parsed and everything else is skipped
+     * (see lazy_value).
+     */
+    class path {
+        struct segment {
+            std::string key;
+            size_t index;               // npos if `key` isn't an array index
+            bool wildcard;
+        };
+        std::vector<segment> segments;
+        bool bad = false;
+
+        void add(std::string key){
+            segment seg;
+            seg.wildcard = key == "*";
+            seg.index = std::string::npos;
+            bool digits = !key.empty() && (key[0] != '0' || key.size() == 1) && key.size() < 19;
+            for(char c : key) digits = digits && '0' <= c && c <= '9';
+            if(digits) seg.index = std::stoull(key);
+            seg.key = std::move(key);
+            segments.push_back(std::move(seg));
         }
-        // }}}
-        // stringify functions
-        // {{{
-        std::string dump(){
-            // FIXME: locale independent dump()
-            if(type == INTEGER){
-                return std::to_string(val.integer);
+        /* The way to a match: the position taken in each container, from the match back up.
+         * The hops live on the stack of walk(). */
+        struct hop {
+            const hop *up;
+            uint32_t pos;
+        };
+        /* Walks a tree through const accessors only, so blocks shared with copies stay shared.
+         * Calls f(match, way to it). */
+        template<typename F>
+        static void walk(const json& j, const segment *seg, const segment *end, const hop *up, F& f){
+            if(seg == end){
+                f(j, up);
+                return;
             }
-            if(type == DECIMAL){
-                return std::to_string(val.decimal);
-            }
-            if(type == BOOLEAN) return val.boolean ? "true" : "false";
-            if(type == UNDEFINED) return "null";
-            if(type == STRING) return '"' + (*val.str) + '"';
-            if(type == ARRAY){
-                std::string ret = "[";
-                for(int i = 0; i < val.array->size(); i++){
-                    ret += (*val.array)[i].dump();
-                    ret += ",";
+            if(j.type == OBJECT){
+                const object o = j.as_obj();
+                if(seg->wildcard){
+                    for(uint32_t i = 0; i < j.len; i++){
+                        hop h{up, i};
+                        walk(o.begin()[i].second, seg + 1, end, &h, f);
+                    }
+                } else {
+                    auto it = o.find(seg->key);
+                    hop h{up, (uint32_t)(it - o.begin())};
+                    if(it != o.end()) walk(it->second, seg + 1, end, &h, f);
                 }
-                ret.pop_back();
-                ret += "]";
-                return ret;
-            }
-            if(type == OBJECT){
-                std::string ret = "{";
-                for(auto& j : *val.object){
-                    ret += '"';
-                    for(char i : j.first){
-                        if(i == '"'){
-                            ret += '\\';
-                            ret += i;
-                        } else if(i <= 0x1f){ // From RFC (7. Strings)
-                            // get top part
-                            int first = i & (0b11110000);
-                            // get bottom part
-                            int second = i & (0b00001111);
-                            char f = (first < 10 ? '0' + first : 'a' + (first - 10));
-                            char s = (second < 10 ? '0' + second : 'a' + (second - 10));
-                            ret += "\\u00";
-                            ret += f;
-                            ret += s;
-                        } else {
-                            ret += i;
-                        }
+            } else if(j.type == ARRAY){
+                if(seg->wildcard){
+                    for(uint32_t i = 0; i < j.len; i++){
+                        hop h{up, i};
+                        walk(j.val.array[i], seg + 1, end, &h, f);
                     }
-                    ret += "\":";
-                    ret += j.second.dump();
-                    ret += ',';
+                } else if(seg->index < j.len){
+                    hop h{up, (uint32_t)seg->index};
+                    walk(j.val.array[seg->index], seg + 1, end, &h, f);
                 }
-                if(!val.object->empty()) ret.pop_back();
-                ret += "}";
-                return ret;
-            }
-            /* If it got to this point, it's of type INVALID_ITEM. */
-            dbg << (type == INVALID_ITEM ? "INVALID" : "NOT INVALID BUT TRAPPING") << '\n';
-            __builtin_trap();
-        }
-        // }}}
-        /* Static functions */
-        // {{{
-        static json make_obj(const std::initializer_list< std::pair<std::string, json> >& t){
-            json ret(OBJECT);
-            std::vector< std::pair<std::string, json> > v(t);
-            for(int i = 0; i < v.size(); i++){
-                ret[v[i].first] = v[i].second;
             }
-            return ret;
         }
-        static json make_arr(const std::initializer_list<json>& t){
-            json ret(ARRAY);
-            ret.as_arr() = t;
-            return ret;
+        /* The match at the end of `way`, for changing: only the containers on the way to it are
+         * made the node's own (see block). */
+        static json& resolve(json& root, const hop *way){
+            if(!way) return root;
+            json& parent = resolve(root, way->up);
+            if(parent.type == OBJECT) return parent.as_obj().begin()[way->pos].second;
+            return parent.as_arr().begin()[way->pos];
         }
-        static inline bool is_space(char c){
-            // Whitespace in JSON is any of 0x20 (space), 0x09 (horizontal tab), 0x0a (\n), 0x0d (\r).
-            return (c == 0x20 || c == 0x09 || c == 0x0a || c == 0x0d);
+        template<typename F>
+        static void walk(lazy_value v, const segment *seg, const segment *end, F& f){
+            if(seg == end){
+                f(v);
+                return;
+            }
+            val_type t = v.type();
+            if(t == OBJECT){
+                if(seg->wildcard){
+                    v.for_each_member([&](std::string_view, lazy_value m){
+                        walk(m, seg + 1, end, f);
+                        return true;
+                    });
+                } else {
+                    lazy_value m = v[seg->key];
+                    if(!m.invalid()) walk(m, seg + 1, end, f);
+                }
+            } else if(t == ARRAY){
+                if(seg->wildcard){
+                    v.for_each_element([&](lazy_value e){
+                        walk(e, seg + 1, end, f);
+                        return true;
+                    });
+                } else if(seg->index != std::string::npos){
+                    lazy_value e = v[seg->index];
+                    if(!e.invalid()) walk(e, seg + 1, end, f);
+                }
+            }
         }
 
-        /* Parses a std::string that would appear in a JSON.
-         * Puts the result value in the std::string, and returns a pointer showing the one directly _after_ it finished parsing.
-         * If the std::string was invalid, the pointer will be (the actual pointer) + (length passed to this function) + 1,
-         * (so > checks are easy to do.)
-         */
-        static const char *parse_string_incomplete(const char *str, const char *end, std::string& result){
-            /* This is not actually that simple. 
-             * Excerpt from RFC:
-             * char = unescaped /
-                  escape (
-                      %x22 /          ; "    quotation mark  U+0022
-                      %x5C /          ; \    reverse solidus U+005C
-                      %x2F /          ; /    solidus         U+002F
-                      %x62 /          ; b    backspace       U+0008
-                      %x66 /          ; f    form feed       U+000C
-                      %x6E /          ; n    line feed       U+000A
-                      %x72 /          ; r    carriage return U+000D
-                      %x74 /          ; t    tab             U+0009
-                      %x75 4HEXDIG )  ; uXXXX
-              */
-            size_t length = end - str;
-            // Check if str starts with '"'.
-            if(*str != '"') return str + length + 1;
-            str++;
-            while(*str != '"' && str != end){
-                /* Annoying part. */
-                if(*str < 0x20){
-                    // These characters have to be escaped.
-                    return str + length + 1;
-                } else if(*str == '\\'){
-                    str++;
-                    /* Literally mean themselves. */
-                    if(*str == '"' || *str == '\\' || *str == '/'){
-                        result += *str;
-                    /* Check the RFC excerpt above. Don't mean themselves. */
-                    } else if(*str == 'b'){
-                        result += (char)0x08;
-                    } else if(*str == 'f'){
-                        result += (char)0x0c;
-                    } else if(*str == 'n'){
-                        result += (char)0x0a;
-                    } else if(*str == 'r'){
-                        result += (char)0x0d;
-                    } else if(*str == 't'){
-                        result += (char)0x09;
-                    } else if(*str == 'u') {
-                        /* Oh god. Unicode handling. */
-                        // In format \uXXXX 
-                        int codepoint = 0;
-                        for(int mul = 4096; mul; mul >>= 4){
-                            str++;
-                            char c = tolower(*str);
-                            if('a' <= c && c <= 'f'){
-                                codepoint += (int)(c - 'a' + 10) * mul;
-                            } else if('0' <= c && c <= '9'){
-                                codepoint += (int)(c - '0' + 10) * mul;
-                            } else {
-                                // Invalid.
-                                return str + length + 1;
-                            }
-                        }
-                        if(codepoint <= 0x007f){ // ASCII range (1 byte)
-                            result += (char)codepoint;
-                        } else if(codepoint <= 0x07ff){ // 2 byte
-                            // Bytes in binary form: 110xxxxx 10xxxxxx, where the `x`s are the binary digits
-                            //                         5 bits  6 bits
-                            result += (char)(0b11111000000 & codepoint);
-                            result += (char)(0b00000111111 & codepoint);
-                        } else if(codepoint <= 0xffff){ // 3 byte
-                            // Bytes in binary form: 1110xxxx 10xxxxxx 10xxxxxx
-                            //                        4 bits   6 bits   6 bits
-                            result += (char)(0b1111000000000000 & codepoint);
-                            result += (char)(0b0000111111000000 & codepoint);
-                            result += (char)(0b0000000000111111 & codepoint);
-                        }
-                        /* Thankfully, we do not have to handle U+10000 to U+10FFFF. */
-                    } else {
-                        // Invalid.
-                        return str + length + 1;
-                    }
-                    str++;
-                } else {
-                    result += *str;
-                    str++;
+        public:
+        /* Compiles `expr`: a JSON Pointer if it's empty or starts with '/', dotted otherwise. */
+        explicit path(std::string_view expr){
+            if(expr.empty()) return;
+            if(expr[0] != '/'){
+                for(size_t start = 0;;){
+                    size_t dot = expr.find('.', start);
+                    add(std::string(expr.substr(start, dot - start)));
+                    if(dot == std::string_view::npos) break;
+                    start = dot + 1;
                 }
+                return;
             }
-            if(str == end){
-                return str + length + 1;
+            std::string key;
+            for(size_t i = 1; i <= expr.size(); i++){
+                if(i == expr.size() || expr[i] == '/'){
+                    add(std::move(key));
+                    key.clear();
+                } else if(expr[i] == '~'){
+                    // ~0 is ~, ~1 is /, and nothing else can follow a ~.
+                    if(i + 1 == expr.size() || (expr[i + 1] != '0' && expr[i + 1] != '1')) bad = true;
+                    else key += expr[++i] == '0' ? '~' : '/';
+                } else {
+                    key += expr[i];
+                }
             }
-            // Get rid of last quote.
-            str++;
-            return str;
+        }
+        /* Whether the pointer had a bad ~ escape. An invalid path matches nothing. */
+        inline bool invalid() const noexcept {
+            return bad;
+        }
+        inline size_t size() const noexcept {
+            return segments.size();
         }
 
-        /* Time to beat RapidJSON. */
-        /* Just to make life easier: */
-#define skip_ws() do { \
-    while(curr != end && is_space(*curr)) curr++; \
-    if(curr == end){ result = INVALID_ITEM; return end; } \
-} while(0);
-#define expect(c) do { \
-    if(curr == end || *curr != c){ result = INVALID_ITEM; return curr; }; \
-    curr++; \
-} while(0);
-        /* Parses the JSON given to it. Returns a std::pair<json, const char*>.
-         * If the JSON was invalid, it returns a json of type INVALID_ITEM.
-         * The char* shows how far it parsed (or where the JSON ended.)
-         */
-        static const char *parse_incomplete(const char *inp, const char *end, json& result){
-            // JSON types: object, array, std::string, numbers, boolean, null
-            // Current character.
-            const char *curr = inp;
+        /* Calls f(const json&) with every match in `root`, in document order. */
+        template<typename F>
+        void for_each(const json& root, F&& f) const {
+            auto match = [&](const json& j, const hop*){
+                f(j);
+            };
+            if(!bad) walk(root, segments.data(), segments.data() + segments.size(), nullptr, match);
+        }
+        /* Calls f(json&) with every match in `root`, in document order. f can change the match,
+         * but not the containers above it. */
+        template<typename F>
+        void for_each(json& root, F&& f) const {
+            auto match = [&](const json&, const hop *way){
+                f(resolve(root, way));
+            };
+            if(!bad) walk(root, segments.data(), segments.data() + segments.size(), nullptr, match);
+        }
+        /* Calls f(lazy_value) with every match under `root`, skipping everything else. */
+        template<typename F>
+        void for_each(lazy_value root, F&& f) const {
+            if(!bad && !root.invalid()) walk(root, segments.data(), segments.data() + segments.size(), f);
+        }
+        /* The first match, or nullptr. */
+        const json *find(const json& root) const {
+            const json *found = nullptr;
+            for_each(root, [&](const json& j){
+                if(!found) found = &j;
+            });
+            return found;
+        }
+        json *find(json& root) const {
+            json *found = nullptr;
+            auto match = [&](const json&, const hop *way){
+                if(!found) found = &resolve(root, way);
+            };
+            if(!bad) walk(root, segments.data(), segments.data() + segments.size(), nullptr, match);
+            return found;
+        }
+        /* Every match in the raw input, each parsed on its own. Nothing else is parsed. */
+        std::vector<json> extract(const char *input, const char *end) const {
+            std::vector<json> matches;
+            lazy_document doc(input, end);
+            for_each(doc.root(), [&](lazy_value v){
+                matches.push_back(v.to_json());
+            });
+            return matches;
+        }
+        std::vector<json> extract(const std::string& input) const {
+            return extract(input.data(), input.data() + input.size());
+        }
+    };
 
-            skip_ws();
+    /* A member of a struct bound with HEX_JSON_BIND(). */
+    template<typename C, typename M>
+    struct field {
+        std::string_view name;
+        M C::*member;
+    };
+    template<typename C, typename M>
+    constexpr field<C, M> make_field(std::string_view name, M C::*member){
+        return {name, member};
+    }
+    /* What a key is told apart by first: its length and first byte. */
+    constexpr uint32_t key_code(std::string_view k){
+        return k.empty() ? 0 : (uint32_t)k.size() << 8 | (unsigned char)k[0];
+    }
 
-            /* Object
-             * { "key1": <member1> , "key2": <member2> , ... }
-             */
-            if(*curr == '{'){
-                result = OBJECT;
-                curr++;
-                skip_ws();
-                // Check for empty object.
-                if(*curr == '}'){
-                    return curr+1;
-                }
-                for(;;){
-                    skip_ws();
-                    std::string key;
-                    const char *next = parse_string_incomplete(curr, end, key);
-                    if(next > end){
-                        result = INVALID_ITEM;
-                        return next - (end-curr) - 1;
-                    }
-                    curr = next;
-                    skip_ws();
-                    expect(':');
-                    result[key] = INVALID_ITEM;
-                    auto& valref = result[key];
-                    /* Recursive time. */
-                    next = parse_incomplete(curr, end, valref);
-                    if(valref.invalid()){
-                        result = INVALID_ITEM;
-                        return next;
-                    }
-                    curr = next;
-                    skip_ws();
-                    if(*curr == '}'){
-                        // End of object.
-                        return curr+1;
-                    } else {
-                        expect(',');
-                    }
-                }
+    /* Reads and writes C++ types straight from and to JSON text, with no tree in between.
+     * Supported: bool, integers, floating point, std::string, hex::json, std::vector, std::optional,
+     * std::map and std::unordered_map with std::string keys, and structs bound with HEX_JSON_BIND().
+     * Everything is validated like parse() does. Members that aren't in the input keep their value,
+     * unknown keys are skipped, and an empty optional is written as null.
+     * Use it through hex::parse_into() and hex::serialize().
+     */
+    class binding {
+        template<typename T> struct is_vector : std::false_type {};
+        template<typename T, typename A> struct is_vector<std::vector<T, A>> : std::true_type {};
+        template<typename T> struct is_optional : std::false_type {};
+        template<typename T> struct is_optional<std::optional<T>> : std::true_type {};
+        template<typename T> struct is_map : std::false_type {};
+        template<typename V, typename C, typename A> struct is_map<std::map<std::string, V, C, A>> : std::true_type {};
+        template<typename V, typename H, typename E, typename A>
+        struct is_map<std::unordered_map<std::string, V, H, E, A>> : std::true_type {};
+        template<typename T, typename = void> struct is_bound : std::false_type {};
+        template<typename T>
+        struct is_bound<T, std::void_t<decltype(hex_json_fields((const T*)nullptr))>> : std::true_type {};
+        template<typename T> struct unsupported : std::false_type {};
+
+        static bool fail(json::sax_state& st, const char *at){
+            st.error = at;
+            return false;
+        }
+        /* Scalars aren't delimited by the index, so nothing may be stuck to their end. */
+        static inline bool scalar_ends(json::sax_state& st, const char *p){
+            return p == st.end || json::is_space(*p) || json::is_op(*p);
+        }
+        static bool read_literal(json::sax_state& st, const char *curr, const char *lit, size_t n){
+            return (size_t)(st.end - curr) >= n && !memcmp(curr, lit, n) && scalar_ends(st, curr + n);
+        }
+        static bool read_number(json::sax_state& st, const char *curr, bool& decimal, int64_t& i, double& d){
+            if(*curr != '-' && (*curr < '0' || *curr > '9')) return fail(st, curr);
+            const char *next = json::read_number(curr, st.end, decimal, i, d);
+            if(!next || !scalar_ends(st, next)) return fail(st, curr);
+            return true;
+        }
+        /* Reads the members of an object, calling member(key) with the index just before each value. */
+        template<typename F>
+        static bool read_object(json::sax_state& st, F&& member){
+            const char *curr = st.index.next();
+            if(curr == st.end || *curr != '{') return fail(st, curr);
+            curr = st.index.next();
+            if(curr != st.end && *curr == '}') return true;
+            for(;;){
+                if(curr == st.end || *curr != '"') return fail(st, curr);
+                std::string_view key;
+                if(!json::read_string(st, curr, key)) return false;
+                curr = st.index.next();
+                if(curr == st.end || *curr != ':') return fail(st, curr);
+                if(!member(key)) return false;
+                curr = st.index.next();
+                if(curr != st.end && *curr == '}') return true;
+                if(curr == st.end || *curr != ',') return fail(st, curr);
+                curr = st.index.next();
             }
+        }
+        static bool skip(json::sax_state& st){
+            sax_handler ignore;
+            return json::parse_value(st, ignore);
+        }
+        /* Reads the member called `key` into `out`, if T has one. */
+        template<typename T, size_t... I>
+        static bool read_field(json::sax_state& st, std::string_view key, T& out, std::index_sequence<I...>){
+            constexpr auto fields = hex_json_fields((const T*)nullptr);
+            uint32_t code = key_code(key);
+            bool ok = true;
+            // The codes and names are constants, so this compiles down to a switch on the code.
+            bool found = ((code == key_code(std::get<I>(fields).name) && key == std::get<I>(fields).name
+                           && (ok = read(st, out.*(std::get<I>(fields).member)), true)) || ...);
+            return found ? ok : skip(st);
+        }
+        template<typename T, size_t... I>
+        static void write_fields(serializer& s, const T& in, std::index_sequence<I...>){
+            constexpr auto fields = hex_json_fields((const T*)nullptr);
+            ((s.raw(I ? "," : "", I ? 1 : 0), s.string(std::get<I>(fields).name), s.put(':'),
+              write(s, in.*(std::get<I>(fields).member))), ...);
+        }
 
-            /* Array
-             * [ <member1> , <member2> , ... ]
-             */
-            else if(*curr == '['){
-                result = ARRAY;
-                curr++;
-                skip_ws();
-                // Check for empty array.
-                if(*curr == ']'){
-                    return curr+1;
+        public:
+        /* Reads one value into `out`. */
+        template<typename T>
+        static bool read(json::sax_state& st, T& out){
+            if constexpr(std::is_same_v<T, json>){
+                json::dom_builder<> builder(out, std::pmr::get_default_resource());
+                return json::parse_value(st, builder);
+            } else if constexpr(is_optional<T>::value){
+                const char *curr = st.index.peek();
+                if(curr != st.end && *curr == 'n'){
+                    st.index.next();
+                    if(!read_literal(st, curr, "null", 4)) return fail(st, curr);
+                    out.reset();
+                    return true;
+                }
+                if(!out) out.emplace();
+                return read(st, *out);
+            } else if constexpr(is_bound<T>::value){
+                constexpr size_t n = std::tuple_size_v<decltype(hex_json_fields((const T*)nullptr))>;
+                return read_object(st, [&](std::string_view key){
+                    return read_field(st, key, out, std::make_index_sequence<n>());
+                });
+            } else if constexpr(is_map<T>::value){
+                return read_object(st, [&](std::string_view key){
+                    return read(st, out[std::string(key)]);
+                });
+            } else if constexpr(is_vector<T>::value){
+                const char *curr = st.index.next();
+                if(curr == st.end || *curr != '[') return fail(st, curr);
+                out.clear();
+                curr = st.index.peek();
+                if(curr != st.end && *curr == ']'){
+                    st.index.next();
+                    return true;
                 }
                 for(;;){
-                    result.push_back(json(INVALID_ITEM));
-                    const char *next = parse_incomplete(curr, end, result.back());
-                    if(result.back().type == INVALID_ITEM){
-                        result = INVALID_ITEM;
-                        return next;
-                    }
-                    curr = next;
-                    skip_ws();
-                    if(*curr == ']'){
-                        // End array
-                        return curr+1;
+                    out.emplace_back();
+                    if(!read(st, out.back())) return false;
+                    curr = st.index.next();
+                    if(curr != st.end && *curr == ']') return true;
+                    if(curr == st.end || *curr != ',') return fail(st, curr);
+                }
+            } else {
+                const char *curr = st.index.next();
+                if(curr == st.end) return fail(st, curr);
+                if constexpr(std::is_same_v<T, bool>){
+                    if(read_literal(st, curr, "true", 4)) out = true;
+                    else if(read_literal(st, curr, "false", 5)) out = false;
+                    else return fail(st, curr);
+                    return true;
+                } else if constexpr(std::is_integral_v<T>){
+                    bool decimal;
+                    int64_t i;
+                    double d;
+                    if(!read_number(st, curr, decimal, i, d)) return false;
+                    if(decimal) return fail(st, curr);
+                    if constexpr(std::is_signed_v<T>){
+                        if(i < std::numeric_limits<T>::min() || i > std::numeric_limits<T>::max()) return fail(st, curr);
                     } else {
-                        expect(',');
+                        if(i < 0 || (uint64_t)i > std::numeric_limits<T>::max()) return fail(st, curr);
                     }
+                    out = (T)i;
+                    return true;
+                } else if constexpr(std::is_floating_point_v<T>){
+                    bool decimal;
+                    int64_t i;
+                    double d;
+                    if(!read_number(st, curr, decimal, i, d)) return false;
+                    out = decimal ? (T)d : (T)i;
+                    return true;
+                } else if constexpr(std::is_same_v<T, std::string>){
+                    std::string_view sv;
+                    if(*curr != '"') return fail(st, curr);
+                    if(!json::read_string(st, curr, sv)) return false;
+                    out.assign(sv);
+                    return true;
+                } else {
+                    static_assert(unsupported<T>::value, "hex::binding: bind this type with HEX_JSON_BIND()");
                 }
             }
-
-            /* String
-             * "x"
-             */
-            else if(*curr == '"'){
-                result = STRING;
-                const char *next = parse_string_incomplete(curr, end, result.as_str());
-                if(next > end){
-                    result = INVALID_ITEM;
-                    return next - (end-curr) - 1;
+        }
+        /* Writes one value. */
+        template<typename T>
+        static void write(serializer& s, const T& in){
+            if constexpr(std::is_same_v<T, json>){
+                s.value(in);
+            } else if constexpr(is_optional<T>::value){
+                if(in) write(s, *in);
+                else s.null();
+            } else if constexpr(is_bound<T>::value){
+                constexpr size_t n = std::tuple_size_v<decltype(hex_json_fields((const T*)nullptr))>;
+                s.put('{');
+                write_fields(s, in, std::make_index_sequence<n>());
+                s.put('}');
+            } else if constexpr(is_map<T>::value){
+                s.put('{');
+                bool first = true;
+                for(const auto& m : in){
+                    if(!first) s.put(',');
+                    first = false;
+                    s.string(m.first);
+                    s.put(':');
+                    write(s, m.second);
                 }
-                return next;
-            }
-
-            /* Number
-             * 31.415e-1
-             */
-            else if(('0' <= *curr && *curr <= '9') || *curr == '-'){
-                // Non-zero numbers can't start with 0.
-                if(*curr == '0' && curr+1 != end && '0' <= *(curr+1) && *(curr+1) <= '9'){
-                    result = INVALID_ITEM;
-                    return curr;
-                }
-                const char *num_start = curr;
-                if(*curr == '-') curr++;
-                while(curr != end && ('0' <= *curr && *curr <= '9')){
-                    curr++;
-                }
-                if(curr != end && (*curr == '.' || tolower(*curr) == 'e')){
-                    /* Decimal */
-                    result = DECIMAL;
-                    if(*curr == '.'){
-                        curr++;
-                        while('0' <= *curr && *curr <= '9') curr++;
-                    }
-                    if(tolower(*curr) == 'e'){
-                        curr++;
-                        if(*curr == '+' || *curr == '-') curr++;
-                        while('0' <= *curr && *curr <= '9') curr++;
-                    }
-                    char *endptr;
-                    result.val.decimal = strtod(num_start, &endptr);
-                    if(endptr != curr){
-                        result = INVALID_ITEM;
-                    }
-                    return endptr;
-                } else {
-                    /* Integer */
-                    result = INTEGER;
-                    std::from_chars(num_start, curr, result.val.integer);
-                    // We already know it's valid and therefore don't need
-                    // to check if the result errored.
-                    return curr;
+                s.put('}');
+            } else if constexpr(is_vector<T>::value){
+                s.put('[');
+                bool first = true;
+                for(const auto& e : in){
+                    if(!first) s.put(',');
+                    first = false;
+                    write(s, e);
                 }
+                s.put(']');
+            } else if constexpr(std::is_same_v<T, bool>){
+                s.boolean(in);
+            } else if constexpr(std::is_integral_v<T>){
+                s.integer((int64_t)in);
+            } else if constexpr(std::is_floating_point_v<T>){
+                s.decimal(in);
+            } else if constexpr(std::is_same_v<T, std::string>){
+                s.string(in);
+            } else {
+                static_assert(unsupported<T>::value, "hex::binding: bind this type with HEX_JSON_BIND()");
             }
+        }
+    };
 
-            /* Booleans
-             * true
-             * false
-             */
-            else if(*curr == 't'){
-                result = BOOLEAN;
-                curr++;
-                expect('r');
-                expect('u');
-                expect('e');
-                result.val.boolean = true;
-                return curr;
-            } else if(*curr == 'f'){
-                result = BOOLEAN;
-                curr++;
-                expect('a');
-                expect('l');
-                expect('s');
-                expect('e');
-                result.val.boolean = false;
-                return curr;
-            }
+    /* Parses [input, end) straight into `out`.
+     * Returns nullptr, or where the input stopped being valid (or stopped matching T's types).
+     */
+    template<typename T>
+    const char *parse_into(const char *input, const char *end, T& out){
+        json::sax_state st(input, end, nullptr);
+        if(!binding::read(st, out)) return st.error ? st.error : end;
+        const char *p = st.index.peek();
+        return p == end ? nullptr : p;
+    }
+    /* Same, into a new T (nothing if the input wasn't valid). */
+    template<typename T>
+    std::optional<T> parse_into(const std::string& input){
+        std::optional<T> out(std::in_place);
+        if(parse_into(input.data(), input.data() + input.size(), *out)) out.reset();
+        return out;
+    }
+    template<typename T>
+    std::string serialize(const T& in){
+        serializer s(nullptr, 256);
+        binding::write(s, in);
+        return s.take();
+    }
+    template<typename T>
+    void serialize(const T& in, sink& out){
+        serializer s(&out);
+        binding::write(s, in);
+        s.flush();
+    }
 
-            /* Null
-             * null
-             */
-            else if(*curr == 'n'){
-                result = UNDEFINED;
-                curr++;
-                expect('u');
-                expect('l');
-                expect('l');
-                return curr;
-            }
+    /* A parser that's given its input a chunk at a time, as it arrives.
+     * feed() gets as far as it can with every chunk and keeps its place, even in the middle of a
+     * string, an escape, a \u sequence or a number. Only a token cut in two by the end of a chunk is
+     * buffered, so memory doesn't depend on the size of the input.
+     * Events go to `Handler`, like with json::parse_sax(). Strings are only valid during the call.
+     */
+    template<typename Handler>
+    class basic_push_parser {
+        public:
+        typedef uint8_t status;
+        /* feed() returns NEED_MORE until a whole value was read and COMPLETE after that (whitespace
+         * can still follow), or INVALID as soon as the input can't be JSON anymore. */
+        static constexpr status NEED_MORE = 0, COMPLETE = 1, INVALID = 2;
 
-            // Otherwise, it's invalid.
-            result = INVALID_ITEM;
-            return curr;
+        private:
+        /* Where in the grammar we are. */
+        enum : uint8_t {
+            VALUE,          // a value
+            FIRST_VALUE,    // a value or ']', right after '['
+            FIRST_KEY,      // a key or '}', right after '{'
+            KEY,            // a key, after ','
+            COLON,          // ':' after a key
+            AFTER_VALUE,    // ',' or the end of the container
+            DONE,           // the whole value was read
+            IN_STRING,      // in a string that started in an earlier chunk
+            IN_SCALAR,      // in a number or literal that started in an earlier chunk
+            FAILED
+        };
+        Handler& h;
+        uint8_t state = VALUE;
+        bool in_key = false;            // whether the string being read is a key
+        bool escaped = false;           // whether the next byte of the string is escaped
+        std::vector<val_type> stack;    // the containers we're in
+        size_t max_depth;
+        std::string token;              // what was seen so far of a token cut by a chunk boundary
+        string_t scratch;               // strings with escapes are decoded here
+        const char *chunk = nullptr;
+        size_t fed = 0;                 // bytes in earlier chunks
+        size_t error = 0;
+        parse_error why = PARSE_OK;
+
+        inline size_t offset(const char *p) const {
+            return fed + (p - chunk);
         }
-#undef expect
-#undef skip_ws
-        static json parse(const char *input, const char *end){
-            json result(INVALID_ITEM);
-            const char *p = parse_incomplete(input, end, result);
-            // Don't waste unnecessary CPU cycles.
-            if(result.invalid()){
-                result.val.invalid_end = p;
-                return result;
+        bool fail(size_t at, parse_error reason = SYNTAX_ERROR){
+            error = at;
+            why = reason;
+            state = FAILED;
+            return false;
+        }
+        /* A value was read: either that's the whole text, or its container goes on. */
+        inline void value_done(){
+            state = stack.empty() ? DONE : AFTER_VALUE;
+        }
+        static inline bool ends_scalar(char c){
+            return json::is_space(c) || json::is_op(c) || c == '"';
+        }
+        /* Finds the closing quote from p on, `escaped` being whether *p is escaped. */
+        static const char *find_quote(const char *p, const char *end, bool& escaped){
+            for(; p != end; p++){
+                if(escaped) escaped = false;
+                else if(*p == '\\') escaped = true;
+                else if(*p == '"') return p;
             }
-            // if is not end of string (minus whitespace)
-            while(p != end){
-                if(!is_space(*p)){
-                    result = INVALID_ITEM;
-                    result.val.invalid_end = p;
-                    return result;
+            return end;
+        }
+        /* Emits the string whose raw body is [body, close), *close being the closing quote and body[0]
+         * being at offset `at`. Bad bytes are reported where they are, like parse() does. */
+        bool emit_string(const char *body, const char *close, size_t at){
+            std::string_view s;
+            bool ascii;
+            const char *special = json::find_special(body, close, ascii);
+            if(!ascii || special != close){
+                const char *bad = json::find_invalid_utf8(body, close);
+                if(bad != close) return fail(at + (bad - body));
+            }
+            if(special == close){
+                s = std::string_view(body, close - body);
+            } else {
+                scratch.assign(body, special);
+                const char *next = json::decode_string(special, close + 1, close + 1 - body, scratch);
+                // decode_string points `length + 1` past the bad byte.
+                if(next > close + 1) return fail(at + (next - (close + 1 - body) - 1 - body));
+                s = scratch;
+            }
+            // A handler that stops is reported at the opening quote.
+            at--;
+            if(in_key){
+                if(!h.on_key(s)) return fail(at, STOPPED);
+                state = COLON;
+            } else {
+                if(!h.on_string(s)) return fail(at, STOPPED);
+                value_done();
+            }
+            return true;
+        }
+        /* Emits the number or literal [b, e), b[0] being at offset `at`. Something that isn't a number
+         * follows `e`. Errors are where parse() puts them: at the start of a bad number or literal, or
+         * right after a good one that has something stuck to it (like `12x` or `truex`). */
+        bool emit_scalar(const char *b, const char *e, size_t at){
+            bool ok;
+            auto literal = [&](const char *s, ptrdiff_t n){
+                return e - b >= n && !memcmp(b, s, n);
+            };
+            if(('0' <= *b && *b <= '9') || *b == '-'){
+                bool decimal;
+                int64_t i;
+                double d;
+                const char *next = json::read_number(b, e, decimal, i, d);
+                if(!next) return fail(at);
+                if(next != e) return fail(at + (next - b));
+                ok = decimal ? h.on_double(d) : h.on_int64(i);
+            } else if(literal("true", 4)){
+                if(e - b != 4) return fail(at + 4);
+                ok = h.on_bool(true);
+            } else if(literal("false", 5)){
+                if(e - b != 5) return fail(at + 5);
+                ok = h.on_bool(false);
+            } else if(literal("null", 4)){
+                if(e - b != 4) return fail(at + 4);
+                ok = h.on_null();
+            } else {
+                return fail(at);
+            }
+            if(!ok) return fail(at, STOPPED);
+            value_done();
+            return true;
+        }
+        /* `p` is at an opening quote. */
+        const char *start_string(const char *p, const char *end){
+            escaped = false;
+            const char *close = find_quote(p + 1, end, escaped);
+            if(close == end){
+                token.assign(p + 1, end);
+                state = IN_STRING;
+                return end;
+            }
+            emit_string(p + 1, close, offset(p + 1));
+            return close + 1;
+        }
+        const char *start_value(const char *p, const char *end){
+            char c = *p;
+            if((c == '{' || c == '[') && stack.size() == max_depth){
+                fail(offset(p), TOO_DEEP);
+                return p;
+            }
+            if(c == '{'){
+                if(h.on_start_object()){
+                    stack.push_back(OBJECT);
+                    state = FIRST_KEY;
+                } else fail(offset(p), STOPPED);
+                return p + 1;
+            }
+            if(c == '['){
+                if(h.on_start_array()){
+                    stack.push_back(ARRAY);
+                    state = FIRST_VALUE;
+                } else fail(offset(p), STOPPED);
+                return p + 1;
+            }
+            if(c == '"'){
+                in_key = false;
+                return start_string(p, end);
+            }
+            if(json::is_op(c)){
+                fail(offset(p));
+                return p;
+            }
+            // A number or a literal, which only ends when something else starts.
+            const char *q = p;
+            while(q != end && !ends_scalar(*q)) q++;
+            if(q == end){
+                token.assign(p, q);
+                state = IN_SCALAR;
+                return q;
+            }
+            emit_scalar(p, q, offset(p));
+            return q;
+        }
+        void end_container(const char *p){
+            val_type t = stack.back();
+            stack.pop_back();
+            if(!(t == OBJECT ? h.on_end_object() : h.on_end_array())){
+                fail(offset(p), STOPPED);
+                return;
+            }
+            value_done();
+        }
+
+        public:
+        /* Containers nested deeper than max_depth fail with TOO_DEEP. */
+        explicit basic_push_parser(Handler& h, size_t max_depth = json::default_max_depth) : h(h), max_depth(max_depth) {}
+        /* Parses the next chunk. The chunk doesn't have to stay around after this returns. */
+        status feed(const char *data, size_t size){
+            const char *p = data, *end = data + size;
+            chunk = data;
+            while(p != end && state != FAILED){
+                if(state == IN_STRING){
+                    const char *close = find_quote(p, end, escaped);
+                    token.append(p, close);
+                    if(close == end) break;
+                    p = close + 1;
+                    token += '"';
+                    emit_string(token.data(), token.data() + token.size() - 1, offset(close) - (token.size() - 1));
+                    continue;
+                }
+                if(state == IN_SCALAR){
+                    const char *q = p;
+                    while(q != end && !ends_scalar(*q)) q++;
+                    token.append(p, q);
+                    if(q == end) break;
+                    p = q;
+                    emit_scalar(token.data(), token.data() + token.size(), offset(p) - token.size());
+                    continue;
+                }
+                char c = *p;
+                if(json::is_space(c)){
+                    p++;
+                    continue;
+                }
+                switch(state){
+                    case FIRST_VALUE:
+                        if(c == ']'){
+                            end_container(p++);
+                            break;
+                        }
+                        [[fallthrough]];
+                    case VALUE:
+                        p = start_value(p, end);
+                        break;
+                    case FIRST_KEY:
+                        if(c == '}'){
+                            end_container(p++);
+                            break;
+                        }
+                        [[fallthrough]];
+                    case KEY:
+                        if(c != '"'){
+                            fail(offset(p));
+                            break;
+                        }
+                        in_key = true;
+                        p = start_string(p, end);
+                        break;
+                    case COLON:
+                        if(c == ':') state = VALUE;
+                        else fail(offset(p));
+                        p++;
+                        break;
+                    case AFTER_VALUE:
+                        if(c == ','){
+                            state = stack.back() == OBJECT ? KEY : VALUE;
+                        } else if(c == (stack.back() == OBJECT ? '}' : ']')){
+                            end_container(p);
+                        } else {
+                            fail(offset(p));
+                        }
+                        p++;
+                        break;
+                    default:
+                        // DONE, only whitespace can follow.
+                        fail(offset(p));
                 }
-                p++;
             }
-            return result;
+            fed += size;
+            return state == FAILED ? INVALID : state == DONE ? COMPLETE : NEED_MORE;
         }
-        static json parse(const std::string& input){
-            return parse(input.c_str(), input.c_str() + input.size());
+        status feed(std::string_view data){
+            return feed(data.data(), data.size());
+        }
+        /* There's no more input. Returns COMPLETE or INVALID, never NEED_MORE. */
+        status finish(){
+            chunk = nullptr;
+            if(state == IN_SCALAR){
+                // token is a std::string, so the number is followed by a '\0'.
+                emit_scalar(token.data(), token.data() + token.size(), fed - token.size());
+            }
+            if(state != DONE && state != FAILED) fail(fed);
+            return state == DONE ? COMPLETE : INVALID;
+        }
+        /* Offset in the whole input where it stopped being valid (after INVALID), and why. */
+        inline size_t error_offset() const noexcept {
+            return error;
+        }
+        inline parse_error error_code() const noexcept {
+            return why;
+        }
+        /* Starts over for another text, keeping the buffers. */
+        void reset(){
+            state = VALUE;
+            stack.clear();
+            fed = error = 0;
+            why = PARSE_OK;
+        }
+    };
+
+    /* A push parser that builds a tree, see basic_push_parser. */
+    class push_parser {
+        json root;
+        json::dom_builder<> builder;
+        basic_push_parser<json::dom_builder<>> parser;
+        public:
+        typedef basic_push_parser<json::dom_builder<>>::status status;
+        static constexpr status NEED_MORE = basic_push_parser<json::dom_builder<>>::NEED_MORE,
+                                COMPLETE = basic_push_parser<json::dom_builder<>>::COMPLETE,
+                                INVALID = basic_push_parser<json::dom_builder<>>::INVALID;
+        explicit push_parser(std::pmr::memory_resource *mr = std::pmr::get_default_resource(),
+                             size_t max_depth = json::default_max_depth)
+            : root(INVALID_ITEM), builder(root, mr), parser(builder, max_depth) {}
+        push_parser(const push_parser&) = delete;
+        status feed(const char *data, size_t size){
+            status s = parser.feed(data, size);
+            if(s == INVALID) root = INVALID_ITEM;
+            return s;
+        }
+        status feed(std::string_view data){
+            return feed(data.data(), data.size());
+        }
+        status finish(){
+            status s = parser.finish();
+            if(s == INVALID) root = INVALID_ITEM;
+            return s;
+        }
+        /* The parsed value, once finish() returned COMPLETE. */
+        inline json& result() noexcept {
+            return root;
+        }
+        inline size_t error_offset() const noexcept {
+            return parser.error_offset();
+        }
+        inline parse_error error_code() const noexcept {
+            return parser.error_code();
         }
-        // }}}
     };
 }
 
 #undef dbg
 
+/* Binds a struct's members to JSON keys of the same name, for hex::parse_into() and hex::serialize():
+ *     struct point { int x, y; std::optional<std::string> label; };
+ *     HEX_JSON_BIND(point, x, y, label)
+ * Use it in the struct's namespace (it's found by argument-dependent lookup), for up to 32 members.
+ */
+#define HEX_JSON_BIND(T, ...) \
+    inline constexpr auto hex_json_fields(const T*){ \
+        return std::make_tuple(HEX_JSON_EXPAND(HEX_JSON_PICK_MAP(__VA_ARGS__, HEX_JSON_MAP32, HEX_JSON_MAP31, HEX_JSON_MAP30, HEX_JSON_MAP29, HEX_JSON_MAP28, HEX_JSON_MAP27, HEX_JSON_MAP26, HEX_JSON_MAP25, HEX_JSON_MAP24, HEX_JSON_MAP23, HEX_JSON_MAP22, HEX_JSON_MAP21, HEX_JSON_MAP20, HEX_JSON_MAP19, HEX_JSON_MAP18, HEX_JSON_MAP17, HEX_JSON_MAP16, HEX_JSON_MAP15, HEX_JSON_MAP14, HEX_JSON_MAP13, HEX_JSON_MAP12, HEX_JSON_MAP11, HEX_JSON_MAP10, HEX_JSON_MAP9, HEX_JSON_MAP8, HEX_JSON_MAP7, HEX_JSON_MAP6, HEX_JSON_MAP5, HEX_JSON_MAP4, HEX_JSON_MAP3, HEX_JSON_MAP2, HEX_JSON_MAP1)(T, __VA_ARGS__))); \
+    }
+#define HEX_JSON_FIELD(T, m) hex::make_field(#m, &T::m)
+#define HEX_JSON_EXPAND(x) x
+#define HEX_JSON_PICK_MAP(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, NAME, ...) NAME
+#define HEX_JSON_MAP1(T, m) HEX_JSON_FIELD(T, m)
+#define HEX_JSON_MAP2(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP1(T, __VA_ARGS__))
+#define HEX_JSON_MAP3(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP2(T, __VA_ARGS__))
+#define HEX_JSON_MAP4(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP3(T, __VA_ARGS__))
+#define HEX_JSON_MAP5(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP4(T, __VA_ARGS__))
+#define HEX_JSON_MAP6(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP5(T, __VA_ARGS__))
+#define HEX_JSON_MAP7(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP6(T, __VA_ARGS__))
+#define HEX_JSON_MAP8(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP7(T, __VA_ARGS__))
+#define HEX_JSON_MAP9(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP8(T, __VA_ARGS__))
+#define HEX_JSON_MAP10(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP9(T, __VA_ARGS__))
+#define HEX_JSON_MAP11(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP10(T, __VA_ARGS__))
+#define HEX_JSON_MAP12(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP11(T, __VA_ARGS__))
+#define HEX_JSON_MAP13(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP12(T, __VA_ARGS__))
+#define HEX_JSON_MAP14(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP13(T, __VA_ARGS__))
+#define HEX_JSON_MAP15(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP14(T, __VA_ARGS__))
+#define HEX_JSON_MAP16(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP15(T, __VA_ARGS__))
+#define HEX_JSON_MAP17(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP16(T, __VA_ARGS__))
+#define HEX_JSON_MAP18(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP17(T, __VA_ARGS__))
+#define HEX_JSON_MAP19(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP18(T, __VA_ARGS__))
+#define HEX_JSON_MAP20(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP19(T, __VA_ARGS__))
+#define HEX_JSON_MAP21(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP20(T, __VA_ARGS__))
+#define HEX_JSON_MAP22(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP21(T, __VA_ARGS__))
+#define HEX_JSON_MAP23(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP22(T, __VA_ARGS__))
+#define HEX_JSON_MAP24(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP23(T, __VA_ARGS__))
+#define HEX_JSON_MAP25(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP24(T, __VA_ARGS__))
+#define HEX_JSON_MAP26(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP25(T, __VA_ARGS__))
+#define HEX_JSON_MAP27(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP26(T, __VA_ARGS__))
+#define HEX_JSON_MAP28(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP27(T, __VA_ARGS__))
+#define HEX_JSON_MAP29(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP28(T, __VA_ARGS__))
+#define HEX_JSON_MAP30(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP29(T, __VA_ARGS__))
+#define HEX_JSON_MAP31(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP30(T, __VA_ARGS__))
+#define HEX_JSON_MAP32(T, m, ...) HEX_JSON_FIELD(T, m), HEX_JSON_EXPAND(HEX_JSON_MAP31(T, __VA_ARGS__))
+
 #endif /* HEX_JSON_HPP */
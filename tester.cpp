@@ -19,13 +19,401 @@ std::string read_file(const std::string& path){
 
 std::string red = "\033[1;31m", green = "\033[1;32m", norm = "\033[0m";
 
+struct point {
+    int x = 0, y = 0;
+    std::optional<std::string> label;
+};
+HEX_JSON_BIND(point, x, y, label)
+struct shape {
+    std::string name;
+    std::vector<point> points;
+    std::map<std::string, double> attributes;
+    hex::json extra;
+};
+HEX_JSON_BIND(shape, name, points, attributes, extra)
+
+int unit_passc = 0, unit_failc = 0;
+void check(bool cond, const std::string& what){
+    if(cond){
+        unit_passc++;
+    } else {
+        std::cout << red << what << " failed\n" << norm;
+        unit_failc++;
+    }
+}
+
+struct counting_handler : hex::sax_handler {
+    int values = 0, depth = 0, max_depth = 0, limit = 100;
+    std::string keys;
+    bool on_start_object(){ max_depth = std::max(max_depth, ++depth); return true; }
+    bool on_end_object(){ depth--; return true; }
+    bool on_key(std::string_view k){ keys += k; return true; }
+    bool on_int64(int64_t){ values++; return true; }
+    bool on_string(std::string_view){ values++; return values < limit; }
+};
+
+void test_sax(){
+    std::string input = "{\"a\": 1, \"b\": {\"c\": \"x\\ty\"}, \"d\": [2, \"z\"]}";
+    counting_handler h;
+    check(hex::json::parse_sax(input.data(), input.data() + input.size(), h) == nullptr, "sax parse");
+    check(h.values == 4 && h.keys == "abcd" && h.max_depth == 2 && h.depth == 0, "sax events");
+    std::string stops = "[\"1\", \"2\", \"3\", \"4\"]";
+    counting_handler s;
+    s.limit = 3;
+    check(hex::json::parse_sax(stops.data(), stops.data() + stops.size(), s) != nullptr && s.values == 3, "sax stop");
+}
+
+void test_push(){
+    std::string input = "{\"key\": [1, -2.5e3, \"a\\\"b\\n\", true, null, {}], \"other\": false}";
+    hex::json expected = hex::json::parse(input);
+    bool same = true;
+    for(size_t cut = 0; cut <= input.size(); cut++){
+        hex::push_parser p;
+        p.feed(input.data(), cut);
+        p.feed(input.data() + cut, input.size() - cut);
+        same = same && p.finish() == hex::push_parser::COMPLETE && p.result() == expected;
+    }
+    check(same, "push parse at every split");
+    hex::push_parser p;
+    check(p.feed("[1, 2") == hex::push_parser::NEED_MORE && p.feed("]") == hex::push_parser::COMPLETE, "push status");
+    hex::push_parser bad;
+    check(bad.feed("[1, ") == hex::push_parser::NEED_MORE && bad.feed("}") == hex::push_parser::INVALID
+          && bad.error_offset() == 4 && bad.result().invalid(), "push error");
+    hex::push_parser cut;
+    cut.feed("{\"a\": 1");
+    check(cut.finish() == hex::push_parser::INVALID, "push truncated");
+    for(std::string bad_string : {"[\"ab\x01c\"]", "[\"a\\qb\"]", "{\"k\\u12\": 1}", "[\"abc\xff\"]", "{\"a\xe2\x82\": 1}",
+                                  "[tru,1]", "[1.e5,1]", "[true,nul]", "[12x,1]", "[truex]", "[-]", "[01]", "[1.5.3]",
+                                  "{\"a\": nul", "[12\"a\"]", "tru", "1."}){
+        size_t at = hex::json::parse(bad_string).val.invalid_end - bad_string.data();
+        bool same_offset = true;
+        for(size_t cut = 0; cut <= bad_string.size(); cut++){
+            hex::push_parser p;
+            p.feed(bad_string.data(), cut);
+            p.feed(bad_string.data() + cut, bad_string.size() - cut);
+            same_offset = same_offset && p.finish() == hex::push_parser::INVALID && p.error_offset() == at;
+        }
+        check(same_offset, "push error offset in " + bad_string);
+    }
+}
+
+void test_many(){
+    std::string input;
+    for(int i = 0; i < 5000; i++) input += "{\"id\": " + std::to_string(i) + ", \"s\": \"}{\"}\n";
+    input += "\"last\" 7 [1,,2]\n";
+    std::vector<hex::json> docs;
+    hex::thread_pool pool(3);
+    size_t n = hex::json::parse_many(input.data(), input.data() + input.size(), [&](hex::json& j){
+        docs.push_back(std::move(j));
+    }, pool, 256);
+    bool ordered = n == 5003 && docs.size() == 5003;
+    for(int i = 0; ordered && i < 5000; i++) ordered = docs[i]["id"].as_int() == i && docs[i]["s"].as_str() == "}{";
+    check(ordered, "parse_many order");
+    check(docs[5000].as_str() == "last" && docs[5001].as_int() == 7 && docs[5002].invalid(), "parse_many scalars and errors");
+}
+
+void test_strings(){
+    hex::json j = hex::json::parse("[\"\\u00e9\\u20AC\", \"\\ud83d\\ude00\", \"caf\xc3\xa9 \\u0041\"]");
+    check(j[0].as_str() == "\xc3\xa9\xe2\x82\xac" && j[1].as_str() == "\xf0\x9f\x98\x80" && j[2].as_str() == "caf\xc3\xa9 A", "unicode escapes");
+    bool rejected = true;
+    for(const char *bad : {"\"\\ud800\"", "\"\\udc00\"", "\"\\ud800\\u0041\"", "\"\\u00g0\""}){
+        rejected = rejected && hex::json::parse(std::string(bad)).invalid();
+    }
+    check(rejected, "lone surrogates");
+    std::string input = "[\"a string long enough for a couple of blocks\", \"ok \xc3\xa9 then \xe2\x82 cut\"]";
+    j = hex::json::parse(input);
+    check(j.invalid() && j.val.invalid_end == input.data() + input.find("\xe2"), "invalid utf-8 offset");
+    rejected = true;
+    for(const char *bad : {"\"\xff\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\"", "\"\xe2\x82\""}){
+        rejected = rejected && hex::json::parse(std::string(bad)).invalid();
+    }
+    check(rejected, "malformed utf-8");
+}
+
+void test_depth(){
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+    hex::json j = hex::json::parse(deep);
+    check(j.invalid() && j.error_code() == hex::TOO_DEEP && j.val.invalid_end == deep.data() + hex::json::default_max_depth, "depth limit");
+    std::string nested = std::string(3000, '[') + "{\"a\": [1, {}]}" + std::string(3000, ']');
+    hex::json k(hex::INVALID_ITEM);
+    hex::json::parse(nested.data(), nested.data() + nested.size(), k, std::pmr::get_default_resource(), 5000);
+    hex::json l = hex::json::parse(nested.substr(2990, nested.size() - 2 * 2990));
+    check(!k.invalid() && !l.invalid() && l[0][0][0][0][0][0][0][0][0][0]["a"][1].type == hex::OBJECT, "configured depth");
+    check(hex::json::parse("[1, 2").error_code() == hex::SYNTAX_ERROR && hex::json::parse("[]").error_code() == hex::PARSE_OK, "error codes");
+    counting_handler h;
+    h.limit = 1;
+    hex::parse_error why;
+    std::string input = "[\"a\", \"b\"]";
+    check(hex::json::parse_sax(input.data(), input.data() + input.size(), h, nullptr, 8, &why) == input.data() + 1 && why == hex::STOPPED, "handler stop code");
+    hex::push_parser push(std::pmr::get_default_resource(), 16);
+    check(push.feed(deep.substr(0, 20)) == hex::push_parser::INVALID && push.error_code() == hex::TOO_DEEP && push.error_offset() == 16, "push depth limit");
+}
+
+void test_parser(){
+    hex::parser p(256);
+    std::string big = "{\"items\": [";
+    for(int i = 0; i < 200; i++) big += (i ? ", " : "") + std::string("{\"id\": ") + std::to_string(i) + ", \"name\": \"item with a long name\"}";
+    big += "], \"note\": \"caf\\u00e9\"}";
+    const hex::json& first = p.parse(big);
+    check(first == hex::json::parse(big) && first["items"][199]["id"].val.integer == 199, "parser result");
+    p.parse(big);
+    size_t capacity = p.capacity();
+    for(int i = 0; i < 3; i++) p.parse(big);
+    check(p.capacity() == capacity && p.parse(big) == hex::json::parse(big), "parser keeps its memory");
+    const hex::json& bad = p.parse("[1, 2,");
+    check(bad.invalid() && p.error_code() == hex::SYNTAX_ERROR && p.error_offset() == 6, "parser error");
+    hex::parser *borrowed;
+    {
+        hex::parser::lease l = hex::parser::acquire();
+        borrowed = &*l;
+        check(l->parse("[true]")[0].val.boolean, "leased parser");
+    }
+    check(&*hex::parser::acquire() == borrowed, "parser pool");
+}
+
+void test_keys(){
+    hex::key_table keys;
+    hex::interned_key name = keys.intern("name"), label = keys.intern("a rather long label");
+    std::string input = "[{\"name\": 1, \"a rather long label\": \"x\"}, {\"a rather long label\": \"y\", \"another long key here\": 2}]";
+    hex::document a = hex::document::parse(input, &keys), b = hex::document::parse(input, &keys);
+    check(a.root() == hex::json::parse(input) && keys.size() == 2, "interned parse");
+    check(a.root()[1].as_obj().begin()->first.view().data() == b.root()[0].as_obj().begin()[1].first.view().data(), "keys stored once");
+    const hex::json& root = a.root();
+    check(root[0][name].val.integer == 1 && root[1][label].as_str() == "y" && root[1][name].invalid(), "interned lookup");
+    hex::json big;
+    for(int i = 0; i < 40; i++) big["a long key number " + std::to_string(i)] = i;
+    check(big[keys.intern("a long key number 33")].val.integer == 33, "interned lookup in a copied key");
+    keys.freeze();
+    hex::document c = hex::document::parse("{\"not in the frozen table\": 1}", &keys);
+    check(keys.size() == 3 && c.root()["not in the frozen table"].val.integer == 1, "frozen table");
+}
+
+void test_writer(){
+    hex::writer w;
+    w.begin_object().key("id").value(42).key("pi").value(2.5).key("name").value("a \"quoted\" name");
+    w.key("tags").begin_array().value(true).null().raw("{\"pre\":[1,2]}").end_array();
+    w.key("empty").begin_object().end_object().key("n").value((size_t)7).end_object();
+    std::string text = w.take();
+    check(text == "{\"id\":42,\"pi\":2.5,\"name\":\"a \\\"quoted\\\" name\",\"tags\":[true,null,{\"pre\":[1,2]}],\"empty\":{},\"n\":7}", "writer");
+    check(hex::json::parse(text)["tags"][2]["pre"][1].val.integer == 2, "writer output parses");
+    hex::writer pretty(nullptr, 2);
+    pretty.begin_array().value(hex::json::parse("{\"a\": [1, {}], \"b\": []}")).value(1).end_array();
+    check(pretty.take() == "[\n  {\n    \"a\": [\n      1,\n      {}\n    ],\n    \"b\": []\n  },\n  1\n]", "pretty writer");
+    std::string streamed;
+    hex::callback_sink out([&](const char *data, size_t size){ streamed.append(data, size); });
+    hex::writer to_sink(&out, 0, 64);
+    to_sink.begin_array();
+    for(int i = 0; i < 100; i++) to_sink.value(i);
+    to_sink.end_array().flush();
+    check(hex::json::parse(streamed).size() == 100 && to_sink.depth() == 0, "writer into a sink");
+    bool thrown = false;
+    try {
+        hex::writer top;
+        top.key("a");
+    } catch(const std::logic_error&){
+        thrown = true;
+    }
+    check(thrown, "writer key outside an object");
+}
+
+void test_minify(){
+    std::string input = "{ \"a b\" :\t[1 , 2.5e3,\n\"x\\\" \\u00e9 \" ],\r\n \"c\": {\"d\" : null , \"e\":[ ]} }  ", out;
+    check(!hex::validate(input) && !hex::minify(input, out) && out == "{\"a b\":[1,2.5e3,\"x\\\" \\u00e9 \"],\"c\":{\"d\":null,\"e\":[]}}", "minify");
+    std::string big = "[";
+    for(int i = 0; i < 5000; i++) big += (i ? " ,\n  " : "") + std::string("{\"k\" : \"v  v\"}");
+    big += "]";
+    check(!hex::minify(big, out) && out.size() == big.size() - 4 * 4999 - 2 * 5000 && hex::json::parse(out) == hex::json::parse(big), "minify across blocks");
+    // No whitespace to strip: the output fills the whole buffer, which has no room to spare.
+    std::string tight = "[12345,\"abcdefgh\"]";
+    std::unique_ptr<char[]> exact(new char[tight.size()]);
+    size_t size;
+    check(!hex::minify(tight.data(), tight.data() + tight.size(), exact.get(), &size) && std::string(exact.get(), size) == tight, "minify into an exact buffer");
+    for(std::string bad : {"[01]", "[1,]", "{\"a\":\"\x01\"}", "[\"\\ud800\"]", "[1] x", "[\"\\q\"]"}){
+        hex::parse_error why;
+        check(hex::validate(bad, &why) == hex::json::parse(bad).val.invalid_end && why == hex::SYNTAX_ERROR && hex::minify(bad, out) && out.empty(), "validate " + bad);
+    }
+}
+
+void test_dump(){
+    hex::json j = hex::json::make_obj({
+        {"s", "a\"b\\c\n\t"},
+        {"e", hex::json::make_arr({})},
+        {"d", hex::json::make_arr({0.1, 1.0, -2.5e-300, 1e300})},
+        {"i", (int64_t)-9007199254740993}
+    });
+    std::string text = j.dump();
+    check(text == "{\"s\":\"a\\\"b\\\\c\\n\\t\",\"e\":[],\"d\":[0.1,1.0,-2.5e-300,1e+300],\"i\":-9007199254740993}", "dump");
+    check(hex::json::parse(text) == j, "dump round trip");
+    check(hex::json("\x01\x1f").dump() == "\"\\u0001\\u001f\"", "dump control characters");
+    std::string pieces;
+    hex::callback_sink out([&](const char *data, size_t size){ pieces.append(data, size); });
+    j.dump(out);
+    check(pieces == text, "dump to sink");
+    hex::json big = hex::json::make_obj({{"small", 1}, {"records", hex::json::make_arr({})}, {"tail", "x"}});
+    for(int i = 0; i < 20000; i++){
+        big["records"].push_back(hex::json::make_obj({{"id", i}, {"name", "record " + std::to_string(i)}, {"w", i / 7.0}}));
+    }
+    hex::thread_pool pool(3);
+    text = big.dump();
+    pieces.clear();
+    big.dump(out, pool);
+    check(big.dump(pool) == text && pieces == text, "parallel dump");
+}
+
+void test_lazy(){
+    std::string input = "{\"skip\": {\"s\": \"]}\\\"\", \"a\": [[], {}]}, \"n\": [1, 2.5, \"x\\ty\", true, null], \"bad\": [1 2]}";
+    hex::lazy_document doc(input);
+    hex::lazy_value root = doc.root();
+    check(root["n"][0].as_int() == 1 && root["n"][1].as_double() == 2.5 && root["n"][2].as_str() == "x\ty"
+          && root["n"][3].as_bool() && root["n"][4].is_null() && root["n"].size() == 5, "lazy lookups");
+    check(root["skip"]["s"].as_str() == "]}\"" && root["skip"]["a"][1].type() == hex::OBJECT, "lazy skipping");
+    check(root["missing"].invalid() && root["n"][5].invalid() && root["bad"].size() == 0, "lazy invalid");
+    check(root["skip"].to_json() == hex::json::parse("{\"s\": \"]}\\\"\", \"a\": [[], {}]}"), "lazy to_json");
+}
+
+void test_path(){
+    std::string input = "{\"events\": [{\"price\": 1}, {\"other\": 0}, {\"price\": 2.5}], \"a/b\": {\"m~n\": 7}}";
+    hex::json j = hex::json::parse(input);
+    hex::path prices("/events/*/price");
+    std::vector<hex::json> found;
+    prices.for_each(j, [&](hex::json& v){ found.push_back(v); });
+    check(found.size() == 2 && found[0].as_int() == 1 && found[1].as_double() == 2.5, "path on tree");
+    std::vector<hex::json> extracted = prices.extract(input);
+    check(extracted.size() == 2 && extracted[0] == found[0] && extracted[1] == found[1], "path on input");
+    check(hex::path("/a~1b/m~0n").find(j)->as_int() == 7 && hex::path("events.2.price").find(j)->as_double() == 2.5, "path syntax");
+    check(hex::path("/events/01").find(j) == nullptr && hex::path("/x~2").invalid(), "path misses");
+    hex::json copy = j;
+    const hex::json& shared = j;
+    check(hex::path("/events/2/price").find(shared)->val.decimal == 2.5 && shared.val.members == copy.val.members, "path query keeps sharing");
+    hex::path("/events/0/price").find(j)->as_int() = 5;
+    const hex::json& original = copy;
+    check(original["events"][0]["price"].val.integer == 1 && shared["a/b"].val.members == original["a/b"].val.members, "path change only copies its way");
+}
+
+void test_binding(){
+    std::string input = "{\"name\": \"tri\", \"skipped\": [{}], \"points\": [{\"x\": 1, \"y\": 2}, {\"y\": 4, \"label\": \"b\", \"x\": 3}],"
+                        " \"attributes\": {\"w\": 1.5}, \"extra\": [true]}";
+    std::optional<shape> s = hex::parse_into<shape>(input);
+    check(s && s->name == "tri" && s->points.size() == 2 && s->points[1].x == 3 && !s->points[0].label
+          && *s->points[1].label == "b" && s->attributes["w"] == 1.5 && s->extra[0].as_bool(), "parse_into");
+    check(s && hex::serialize(*s) == "{\"name\":\"tri\",\"points\":[{\"x\":1,\"y\":2,\"label\":null},{\"x\":3,\"y\":4,\"label\":\"b\"}],"
+          "\"attributes\":{\"w\":1.5},\"extra\":[true]}", "serialize");
+    check(!hex::parse_into<point>("{\"x\": 1.5}") && !hex::parse_into<point>("{\"x\": 1,}"), "parse_into errors");
+}
+
+void test_numbers(){
+    hex::json j = hex::json::parse("[9223372036854775807, -9223372036854775808, 9223372036854775808, 0.1, 2.5e-3, 1e400, 4.9406564584124654e-324, 123456789012345678901234567890]");
+    check(j[0].type == hex::INTEGER && j[0].as_int() == INT64_MAX && j[1].as_int() == INT64_MIN, "int64 limits");
+    check(j[2].type == hex::DECIMAL && j[2].as_double() == 9223372036854775808.0, "int64 overflow to double");
+    check(j[3].as_double() == 0.1 && j[4].as_double() == 2.5e-3 && j[5].as_double() == HUGE_VAL
+          && j[6].as_double() == 4.9406564584124654e-324 && j[7].as_double() == 123456789012345678901234567890.0, "decimals");
+    bool rejected = true;
+    for(const char *bad : {"-", "-.5", "-01", "1.", "1.e5", "1e", "1e+", "01", "0x1", "1.5.5"}){
+        rejected = rejected && hex::json::parse(std::string(bad)).invalid();
+    }
+    check(rejected, "number grammar");
+}
+
+void test_objects(){
+    hex::json j = hex::json::parse("{\"b\": 1, \"a\": 2, \"b\": 3, \"a long key that is not inline\": 4}");
+    check(j.size() == 3, "duplicate keys");
+    check(j["b"].as_int() == 3, "last duplicate wins");
+    auto it = j.as_obj().begin();
+    check(it->first == "b" && (it + 1)->first == "a", "insertion order");
+    check(j["a long key that is not inline"].as_int() == 4, "long key lookup");
+    hex::json big(hex::OBJECT);
+    for(int i = 0; i < 100; i++) big[std::to_string(i)] = i;
+    bool found = true;
+    for(int i = 0; i < 100; i++) found = found && big[std::to_string(i)].as_int() == i;
+    check(found && big.size() == 100, "hashed lookup");
+    big.as_obj().erase("50");
+    check(big.size() == 99 && big.as_obj().find("50") == big.as_obj().end() && big["99"].as_int() == 99, "erase");
+    check(hex::json::parse("{\"x\": 1, \"y\": 2}") == hex::json::parse("{\"y\": 2, \"x\": 1}"), "unordered equality");
+}
+
+void test_nodes(){
+    check(sizeof(hex::json) == 16, "node size");
+    hex::json s = std::string("fourteen bytes");
+    hex::json l = std::string("fifteen bytes..");
+    check((s.flags & hex::json::INLINE) && !(l.flags & hex::json::INLINE) && s.size() == 14 && l.as_str() == "fifteen bytes..", "inline strings");
+    s = std::string(s.as_str()) + "!";
+    l = l.as_str().substr(0, 3);
+    check(s.as_str() == "fourteen bytes!" && l.as_str() == "fif", "string reassignment");
+    hex::json a = hex::json::make_arr({1, "x"});
+    for(int i = 0; i < 20; i++) a.push_back(a[i]);
+    check(a.size() == 22 && a[21].as_str() == "x" && a.back() == a[1], "push_back of own element");
+    hex::json b(a);
+    b.pop_back();
+    check(b.size() == 21 && b != a && hex::json(a) == a, "array copies");
+}
+
+void test_sharing(){
+    hex::json a = hex::json::parse("{\"list\": [1, 2, {\"s\": \"a string that is not inline\"}], \"n\": 1}");
+    hex::json b = a;
+    check(b.val.members == a.val.members && b["list"].val.array == a["list"].val.array, "copies share payloads");
+    b["list"][2]["s"] = "changed";
+    b["n"] = 2;
+    check(a["list"][2]["s"].as_str() == "a string that is not inline" && a["n"].as_int() == 1 && b["list"][2]["s"].as_str() == "changed", "copy on write");
+    hex::json c = a;
+    c["list"][0] = c;
+    c["list"].push_back(c);
+    check(c["list"][0] == a && c["list"].size() == 4 && c["list"][3]["list"][0] == a, "assigning a value that contains the node");
+    hex::json m;
+    m = std::move(c);
+    check(c.invalid() && m["list"].size() == 4, "move assignment");
+}
+
+void test_document(){
+    hex::document d = hex::document::parse("{\"a\": 1, \"b\": true, \"c\": null}");
+    hex::json& root = d.root();
+    root["a"] = std::string(100, 'x');
+    root["b"] = hex::ARRAY;
+    root["b"].push_back(std::string(50, 'y'));
+    check(root["a"].as_str() == std::string(100, 'x') && root["a"].resource() == d.resource()
+          && root["b"].resource() == d.resource() && root["b"][0].resource() == d.resource(), "payloads of document scalars");
+    hex::document n = hex::document::parse("5");
+    n.root() = hex::OBJECT;
+    n.root()["k"] = std::string_view("a string that is not inline");
+    check(n.root().resource() == n.resource() && n.root()["k"].resource() == n.resource(), "payload of a scalar document root");
+    hex::json shared = hex::json::parse("{\"list\": [1, 2, \"a string that is not inline\"]}");
+    hex::json moved = shared;
+    root["d"] = 1;
+    root["d"] = shared;
+    root["e"] = 2;
+    root["e"] = std::move(moved);
+    check(root["d"] == shared && root["e"] == shared && root["d"].val.members != shared.val.members
+          && root["d"].resource() == d.resource() && root["d"]["list"][2].resource() == d.resource()
+          && root["e"].resource() == d.resource() && root["e"]["list"][2].resource() == d.resource(), "shared value assigned into a document");
+    hex::json h(5);
+    h = std::string(100, 'z');
+    check(h.resource() == std::pmr::get_default_resource(), "payloads of heap scalars");
+}
+
+void test_snapshot(){
+    hex::json j = hex::json::parse("{\"name\": \"a string longer than inline\", \"n\": [1, 2.5, true, null, \"x\"], \"e\": {}}");
+    for(int i = 0; i < 40; i++) j["k" + std::to_string(i)] = i;
+    std::string bytes = hex::snapshot::encode(j);
+    hex::snapshot snap(bytes.data(), bytes.size());
+    hex::snapshot_value root = snap.root();
+    check(!snap.invalid() && root.size() == 43 && root["k39"].as_int() == 39 && root["k40"].invalid(), "snapshot lookup");
+    check(root["name"].as_str() == "a string longer than inline" && root["n"][1].as_double() == 2.5 && root["n"][3].is_null(), "snapshot values");
+    check(root.dump() == j.dump() && root.to_json() == j, "snapshot round trip");
+    check(hex::snapshot("not a snapshot, but long enough for a header", 44).invalid(), "snapshot header");
+}
+
 /* Tests the JSON library. */
 int main(int argc, char *argv[]){
     int passc = 0, failc = 0, num = 0;
+    hex::parser reused;
     std::cout << "Fail testing...\n";
     for(const auto& fail : fs::directory_iterator("./fail/")){
-        hex::json j = hex::json::parse(read_file(fail.path()));
-        if(j.invalid()){
+        std::string input = read_file(fail.path());
+        hex::json j = hex::json::parse(input);
+        hex::document doc = hex::document::parse(input);
+        hex::document insitu = hex::document::parse_insitu(input);
+        hex::mapped_document mapped(fail.path().string());
+        if(j.invalid() && doc.invalid() && insitu.invalid() && mapped.invalid() && reused.parse(input).invalid()
+           && hex::validate(input) == j.val.invalid_end){
             passc++;
         } else {
             std::cout << red << fail.path().filename() << " failed\n" << norm;
@@ -43,8 +431,15 @@ int main(int argc, char *argv[]){
     std::cout << "Pass testing...\n";
     passc = failc = 0;
     for(const auto& pass : fs::directory_iterator("./pass/")){
-        hex::json j = hex::json::parse(read_file(pass.path()));
-        if(!j.invalid()){
+        std::string input = read_file(pass.path());
+        hex::json j = hex::json::parse(input);
+        hex::document doc = hex::document::parse(input);
+        hex::document insitu = hex::document::parse_insitu(input);
+        hex::mapped_document mapped(pass.path().string());
+        std::string minified;
+        if(!j.invalid() && doc.root() == j && insitu.root() == j && mapped.root() == j && reused.parse(input) == j
+           && !hex::minify(input, minified) && hex::json::parse(minified) == j
+           && hex::json::parse_file(pass.path().string()) == j){
             passc++;
         } else {
             std::cout << red << pass.path().filename() << " failed\n" << norm;
@@ -58,4 +453,31 @@ int main(int argc, char *argv[]){
         std::cout << red << failc << " tests failed";
     }
     std::cout << '\n' << norm;
+    std::cout << "Unit testing...\n";
+    test_objects();
+    test_nodes();
+    test_sharing();
+    test_document();
+    test_snapshot();
+    test_sax();
+    test_push();
+    test_depth();
+    test_parser();
+    test_keys();
+    test_many();
+    test_strings();
+    test_dump();
+    test_writer();
+    test_minify();
+    test_lazy();
+    test_path();
+    test_binding();
+    test_numbers();
+    std::cout << "Unit test results: Out of " << unit_passc + unit_failc << " tests, ";
+    if(unit_passc) std::cout << green << unit_passc << " tests passed";
+    if(unit_failc){
+        if(unit_passc) std::cout << ", ";
+        std::cout << red << unit_failc << " tests failed";
+    }
+    std::cout << '\n' << norm;
 }
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <string>
+// The stats hooks change what every parse compiles to, so they're tested on their own: the main
+// suite in tester.cpp runs without them, the way the library is normally built.
+#define HEX_JSON_STATS
+#include "json.hpp"
+
+std::string red = "\033[1;31m", green = "\033[1;32m", norm = "\033[0m";
+
+int unit_passc = 0, unit_failc = 0;
+void check(bool cond, const std::string& what){
+    if(cond){
+        unit_passc++;
+    } else {
+        std::cout << red << what << " failed\n" << norm;
+        unit_failc++;
+    }
+}
+
+void test_stats(){
+    std::string input = "{\"a\": [1, 2.5, \"x\\ty\\n\", true, null, {}], \"a key longer than inline\": {\"b\": []}}";
+    hex::parse_stats stats;
+    {
+        hex::stats_scope scope(stats);
+        hex::json j = hex::json::parse(input);
+        hex::document doc = hex::document::parse(input);
+    }
+    hex::json::parse(input);
+    check(stats.bytes == 2 * input.size() && stats.values[hex::OBJECT] == 6 && stats.values[hex::ARRAY] == 4
+          && stats.values[hex::INTEGER] == 2 && stats.values[hex::DECIMAL] == 2 && stats.values[hex::STRING] == 2
+          && stats.values[hex::BOOLEAN] == 2 && stats.values[hex::UNDEFINED] == 2 && stats.keys == 6, "stats counts");
+    check(stats.max_depth == 3 && stats.string_bytes == 2 * (1 + 6 + 24 + 1) && stats.escapes == 4, "stats strings");
+    check(stats.allocations > 0 && stats.allocated_bytes > 0 && stats.scan_ns > 0, "stats memory and time");
+
+    std::string numbers = "[0, -7, 2.5, 1e3, -4E-2, 9223372036854775807, -9223372036854775808, 9223372036854775808, 12345678901234567890]";
+    hex::parse_stats parsed, validated, minified;
+    {
+        hex::stats_scope scope(parsed);
+        hex::json::parse(numbers);
+    }
+    {
+        hex::stats_scope scope(validated);
+        hex::validate(numbers);
+    }
+    {
+        hex::stats_scope scope(minified);
+        std::string out;
+        hex::minify(numbers, out);
+    }
+    check(parsed.values[hex::INTEGER] == 4 && parsed.values[hex::DECIMAL] == 5
+          && validated.values[hex::INTEGER] == 4 && validated.values[hex::DECIMAL] == 5
+          && minified.values[hex::INTEGER] == 4 && minified.values[hex::DECIMAL] == 5, "stats numbers without decoding");
+}
+
+/* Tests the parse statistics. */
+int main(){
+    std::cout << "Stats testing...\n";
+    test_stats();
+    std::cout << "Stats test results: Out of " << unit_passc + unit_failc << " tests, ";
+    if(unit_passc) std::cout << green << unit_passc << " tests passed";
+    if(unit_failc){
+        if(unit_passc) std::cout << ", ";
+        std::cout << red << unit_failc << " tests failed";
+    }
+    std::cout << '\n' << norm;
+    return unit_failc ? EXIT_FAILURE : EXIT_SUCCESS;
+}